@@ -0,0 +1,98 @@
+// Thread scaling report for boruvka(): 1..N threads on a text graph (g1000
+// by default) and on a generated 10M-edge graph, kruskal() as the baseline.
+//
+// usage: bench_boruvka [max threads] [graph file] [generated edge count]
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "bench_common.h"
+#include "boruvka.h"
+#include "csr_graph.h"
+#include "kruskal.h"
+
+using Graph_t = CsrGraph<bench::Vertex, bench::Edge>;
+
+template<typename F>
+double best_of(int runs, F&& f) {
+  double best = 1e300;
+  for (int i = 0; i < runs; ++i) {
+    bench::Timer timer;
+    f();
+    best = std::min(best, timer.Ms());
+  }
+  return best;
+}
+
+void report(const char* name, const Graph_t& g, size_t max_threads) {
+  const int runs = 3;
+  size_t mst_size = 0;
+
+  const double baseline =
+    best_of(runs, [&] { mst_size = kruskal(g).size(); });
+
+  std::printf(
+    "%s: V=%zu E=%zu mst=%zu\n", name, g.Size(), g.GetEdges().size(), mst_size
+  );
+  std::printf(
+    "  %-8s %10s %10s %10s\n", "threads", "ms", "speedup", "vs kruskal"
+  );
+  std::printf("  %-8s %10.1f %10s %10s\n", "kruskal", baseline, "-", "1.00");
+
+  double single = 0;
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    ThreadPool pool{threads};
+    const double ms = best_of(runs, [&] { boruvka(g, pool); });
+    if (threads == 1) {
+      single = ms;
+    }
+    std::printf(
+      "  %-8zu %10.1f %10.2f %10.2f\n",
+      threads,
+      ms,
+      single / ms,
+      baseline / ms
+    );
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Args args{
+    argc,
+    argv,
+    "bench_boruvka [max threads] [graph file] [generated edge count]"
+  };
+  const size_t max_threads = args.Number<size_t>(
+    1, std::max<size_t>(1, std::thread::hardware_concurrency())
+  );
+  const char* filename = argc > 2 ? argv[2] : "g1000";
+  const size_t generated = args.Number<size_t>(3, 10000000);
+  if (!args.Valid()) {
+    return 1;
+  }
+
+  try {
+    size_t V = 0;
+    std::vector<bench::Edge> edges = bench::load_text_graph(filename, V);
+    Graph_t g;
+    for (size_t i = 0; i < V; ++i) {
+      g.InsertVertex(bench::Vertex(i));
+    }
+    g.BuildFromEdgeArray(edges.data(), edges.size());
+    report(filename, g, max_threads);
+  } catch (const char* error) {
+    std::fprintf(stderr, "%s: %s\n", filename, error);
+  }
+
+  {
+    std::vector<bench::Edge> edges =
+      bench::random_edges(generated / 10, generated, 280);
+    Graph_t g;
+    g.BuildFromEdgeArray(edges.data(), edges.size());
+    edges = {};
+    report("random", g, max_threads);
+  }
+
+  return 0;
+}
@@ -0,0 +1,198 @@
+/*!
+  \brief  Shared pieces of the benchmark executables: vertex/edge types
+  matching the driver's, a wall-clock timer, the text graph loader and the
+  numeric argument parser
+*/
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace bench {
+  /**
+   * @brief Same layout and interface as the driver's Edge
+   */
+  class Edge {
+  public:
+
+    Edge(size_t id1 = 0, size_t id2 = 0, float weight = 0):
+        id1(id1), id2(id2), weight(weight) {}
+
+    size_t ID1() const { return id1; }
+
+    size_t ID2() const { return id2; }
+
+    float Weight() const { return weight; }
+
+    bool operator<(const Edge& rhs) const {
+      return weight < rhs.weight || (weight == rhs.weight && id1 < rhs.id1)
+          || (weight == rhs.weight && id1 == rhs.id1 && id2 < rhs.id2);
+    }
+
+  private:
+
+    size_t id1;
+    size_t id2;
+    float weight;
+  };
+
+  class Vertex {
+  public:
+
+    Vertex(size_t _id = 0): id(_id) {}
+
+    size_t ID() const { return id; }
+
+    bool operator<(const Vertex& rhs) const { return id < rhs.id; }
+
+  private:
+
+    size_t id;
+  };
+
+  /**
+   * @brief Milliseconds since construction (or the last Reset)
+   */
+  class Timer {
+  public:
+
+    Timer(): start(std::chrono::steady_clock::now()) {}
+
+    auto Reset() -> void { start = std::chrono::steady_clock::now(); }
+
+    [[nodiscard]] auto Ms() const -> double {
+      return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start
+      )
+        .count();
+    }
+
+  private:
+
+    std::chrono::steady_clock::time_point start;
+  };
+
+  /**
+   * @class Args
+   * @brief Numeric positional arguments: a missing one takes its default, a
+   * malformed one (or --help) makes Valid() print the usage line and fail
+   */
+  class Args {
+  public:
+
+    Args(int argc, char** argv, const char* usage):
+        argc(argc), argv(argv), usage(usage) {}
+
+    Args(const Args&) = delete;
+    Args& operator=(const Args&) = delete;
+
+    /**
+     * @brief argv[index] as a T (unsigned digits only for integers), or
+     * 'fallback' if there are fewer arguments
+     */
+    template<typename T>
+    [[nodiscard]] auto Number(const int index, const T fallback) -> T {
+      if (index >= argc) {
+        return fallback;
+      }
+
+      const char* const text = argv[index];
+      char* end = nullptr;
+      T value{};
+      errno = 0;
+      if constexpr (std::is_floating_point_v<T>) {
+        value = static_cast<T>(std::strtod(text, &end));
+      } else if (*text >= '0' && *text <= '9') {
+        // strtoull would take a sign, so the text must start with a digit
+        const unsigned long long parsed = std::strtoull(text, &end, 10);
+        if (parsed > static_cast<unsigned long long>(
+                       std::numeric_limits<T>::max()
+                     )) {
+          errno = ERANGE;
+        }
+        value = static_cast<T>(parsed);
+      }
+
+      if (end == nullptr || end == text || *end != '\0' || errno != 0) {
+        valid = false;
+        return fallback;
+      }
+      return value;
+    }
+
+    /**
+     * @brief Whether every argument parsed, prints the usage line if not
+     */
+    [[nodiscard]] auto Valid() const -> bool {
+      if (!valid) {
+        std::fprintf(stderr, "usage: %s\n", usage);
+      }
+      return valid;
+    }
+
+  private:
+
+    int argc;
+    char** argv;
+    const char* usage;
+    bool valid{true};
+  };
+
+  /**
+   * @brief Reads a "V M / u v w" file, both directions of every edge
+   */
+  inline auto load_text_graph(const char* filename, size_t& vertex_count)
+    -> std::vector<Edge> {
+    std::ifstream in(filename);
+    if (in.fail()) {
+      throw "Cannot open input file";
+    }
+
+    size_t V, M;
+    in >> V >> M;
+    vertex_count = V;
+
+    std::vector<Edge> edges;
+    edges.reserve(2 * M);
+    for (size_t e = 0; e < M; ++e) {
+      size_t v1, v2, w;
+      in >> v1 >> v2 >> w;
+      edges.emplace_back(v1, v2, w);
+      edges.emplace_back(v2, v1, w);
+    }
+    return edges;
+  }
+
+  /**
+   * @brief Connected graph with V vertices and M edges (M >= V - 1): a
+   * random spanning path plus uniformly random extra edges, fixed seed
+   */
+  inline auto random_edges(size_t V, size_t M, uint64_t seed)
+    -> std::vector<Edge> {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<size_t> vertex(0, V - 1);
+    std::uniform_real_distribution<float> weight(0.0f, 1.0f);
+
+    std::vector<Edge> edges;
+    edges.reserve(M);
+    for (size_t i = 0; i + 1 < V; ++i) {
+      edges.emplace_back(i, i + 1, weight(gen));
+    }
+    while (edges.size() < M) {
+      edges.emplace_back(vertex(gen), vertex(gen), weight(gen));
+    }
+    return edges;
+  }
+}
+
+#endif
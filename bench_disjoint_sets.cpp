@@ -0,0 +1,174 @@
+// Make / Join / GetRepresentative cost of each union-find backend, as JSON
+// (one record per backend, join pattern, size and operation):
+//
+//   star_into_0   Join(0, i)   everything into 0, as test6
+//   star_from_0   Join(i, 0)   the same, arguments swapped, as test7
+//   chain         Join(i, i + 1)
+//   random        n - 1 joins of uniformly random pairs (fixed seed)
+//
+// GetRepresentative is timed on n random IDs after the joins, and for
+// DisjointSets also the same IDs through the batched GetRepresentatives.
+//
+// usage: bench_disjoint_sets [max size] [repetitions]
+//        sizes are 1e3, 1e4, ... up to max size (default 1e7; DisjointSets
+//        needs about 64 bytes per element, so 1e8 wants 8 GB of memory)
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "bench_common.h"
+#include "concurrent_union_find.h"
+#include "disjoint_sets.h"
+#include "union_find.h"
+
+namespace {
+  using Pairs = std::vector<std::pair<size_t, size_t>>;
+
+  auto join_pattern(const std::string& pattern, const size_t n) -> Pairs {
+    Pairs pairs{};
+    pairs.reserve(n - 1);
+
+    std::mt19937_64 gen(280);
+    std::uniform_int_distribution<size_t> id(0, n - 1);
+    for (size_t i = 1; i < n; ++i) {
+      if (pattern == "star_into_0") {
+        pairs.emplace_back(0, i);
+      } else if (pattern == "star_from_0") {
+        pairs.emplace_back(i, 0);
+      } else if (pattern == "chain") {
+        pairs.emplace_back(i - 1, i);
+      } else {
+        pairs.emplace_back(id(gen), id(gen));
+      }
+    }
+    return pairs;
+  }
+
+  bool first_record = true;
+  volatile size_t sink = 0;
+
+  void record(
+    const char* backend,
+    const std::string& pattern,
+    const size_t n,
+    const char* op,
+    const size_t ops,
+    const double ms
+  ) {
+    const double ns = ms * 1e6 / static_cast<double>(ops);
+    std::printf(
+      "%s\n    {\"backend\": \"%s\", \"pattern\": \"%s\", \"size\": %zu, "
+      "\"op\": \"%s\", \"ops\": %zu, \"ns_per_op\": %.3f, "
+      "\"ops_per_sec\": %.0f}",
+      first_record ? "" : ",",
+      backend,
+      pattern.c_str(),
+      n,
+      op,
+      ops,
+      ns,
+      ns > 0 ? 1e9 / ns : 0.0
+    );
+    first_record = false;
+  }
+
+  /**
+   * @brief Best of 'runs' timings of every phase on a fresh structure
+   */
+  template<typename Sets>
+  void run(
+    const char* backend,
+    const std::string& pattern,
+    const size_t n,
+    const Pairs& pairs,
+    const std::vector<size_t>& queries,
+    const int runs
+  ) {
+    double make_ms = 1e300, join_ms = 1e300, find_ms = 1e300;
+    double batch_ms = 1e300;
+    size_t checksum = 0;
+    std::vector<size_t> representatives(queries.size());
+
+    for (int r = 0; r < runs; ++r) {
+      Sets set{n};
+
+      bench::Timer timer;
+      for (size_t i = 0; i < n; ++i) {
+        set.Make();
+      }
+      make_ms = std::min(make_ms, timer.Ms());
+
+      timer.Reset();
+      for (const auto& [a, b]: pairs) {
+        set.Join(a, b);
+      }
+      join_ms = std::min(join_ms, timer.Ms());
+
+      timer.Reset();
+      for (const size_t id: queries) {
+        checksum += set.GetRepresentative(id);
+      }
+      find_ms = std::min(find_ms, timer.Ms());
+
+      if constexpr (std::is_same_v<Sets, DisjointSets>) {
+        timer.Reset();
+        set.GetRepresentatives(queries, representatives);
+        batch_ms = std::min(batch_ms, timer.Ms());
+        checksum += representatives.back();
+      }
+    }
+
+    record(backend, pattern, n, "Make", n, make_ms);
+    record(backend, pattern, n, "Join", pairs.size(), join_ms);
+    record(backend, pattern, n, "GetRepresentative", queries.size(), find_ms);
+    if constexpr (std::is_same_v<Sets, DisjointSets>) {
+      record(
+        backend, pattern, n, "GetRepresentatives", queries.size(), batch_ms
+      );
+    }
+
+    // keeps the finds from being optimised away
+    sink = sink + checksum;
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Args args{argc, argv, "bench_disjoint_sets [max size] [repetitions]"};
+  const size_t max_size = args.Number<size_t>(1, 10000000);
+  const int repetitions = args.Number<int>(2, 5);
+  if (!args.Valid()) {
+    return 1;
+  }
+
+  const std::string patterns[] = {
+    "star_into_0", "star_from_0", "chain", "random"
+  };
+
+  std::printf("{\n  \"benchmark\": \"disjoint_sets\",\n  \"results\": [");
+  for (size_t n = 1000; n <= max_size; n *= 10) {
+    // large sizes are one run, the small ones are repeated for stable times
+    const int runs = n >= 1000000 ? 1 : repetitions;
+
+    std::vector<size_t> queries(n);
+    std::mt19937_64 gen(280);
+    std::uniform_int_distribution<size_t> id(0, n - 1);
+    for (size_t& query: queries) {
+      query = id(gen);
+    }
+
+    for (const std::string& pattern: patterns) {
+      const Pairs pairs = join_pattern(pattern, n);
+      run<DisjointSets>("DisjointSets", pattern, n, pairs, queries, runs);
+      run<UnionFind>("UnionFind", pattern, n, pairs, queries, runs);
+      run<ConcurrentUnionFind>(
+        "ConcurrentUnionFind", pattern, n, pairs, queries, runs
+      );
+    }
+  }
+  std::printf("\n  ]\n}\n");
+  return 0;
+}
@@ -0,0 +1,150 @@
+// Sparse ID renumbering: DenseIdMap against std::map (what Graph keys its
+// vertices by) and std::unordered_map, building the mapping from n random
+// 64-bit IDs and then looking up n random IDs that are present.
+//
+// usage: bench_id_map [max n] [repetitions]
+//        n is 1e4, 1e5, ... up to max n (default 1e7)
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "bench_common.h"
+#include "id_map.h"
+
+namespace {
+  volatile size_t sink = 0;
+
+  struct Timing {
+    double insert_ms{1e300};
+    double find_ms{1e300};
+  };
+
+  /**
+   * @brief Best of 'runs': inserting 'ids' (dense index = insertion order)
+   * and looking up 'queries'
+   */
+  template<typename Insert, typename Find>
+  Timing measure(
+    const std::vector<uint64_t>& ids,
+    const std::vector<uint64_t>& queries,
+    const int runs,
+    Insert insert,
+    Find find
+  ) {
+    Timing best{};
+    for (int r = 0; r < runs; ++r) {
+      size_t checksum = 0;
+      bench::Timer timer;
+      auto table = insert(ids);
+      best.insert_ms = std::min(best.insert_ms, timer.Ms());
+
+      timer.Reset();
+      for (const uint64_t id: queries) {
+        checksum += find(table, id);
+      }
+      best.find_ms = std::min(best.find_ms, timer.Ms());
+      sink = sink + checksum;
+    }
+    return best;
+  }
+
+  void report(const char* name, const size_t n, const Timing& t) {
+    const double count = static_cast<double>(n);
+    std::printf(
+      "%-20s %10zu %12.1f %12.1f\n",
+      name,
+      n,
+      t.insert_ms * 1e6 / count,
+      t.find_ms * 1e6 / count
+    );
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Args args{argc, argv, "bench_id_map [max n] [repetitions]"};
+  const size_t max_n = args.Number<size_t>(1, 10000000);
+  const int repetitions = args.Number<int>(2, 3);
+  if (!args.Valid()) {
+    return 1;
+  }
+
+  std::printf(
+    "%-20s %10s %12s %12s\n", "table", "n", "insert ns", "find ns"
+  );
+  for (size_t n = 10000; n <= max_n; n *= 10) {
+    std::mt19937_64 gen(21);
+    std::vector<uint64_t> ids(n);
+    for (uint64_t& id: ids) {
+      id = gen();
+    }
+    std::vector<uint64_t> queries(n);
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    for (uint64_t& query: queries) {
+      query = ids[pick(gen)];
+    }
+
+    report(
+      "DenseIdMap",
+      n,
+      measure(
+        ids,
+        queries,
+        repetitions,
+        [](const std::vector<uint64_t>& keys) {
+          DenseIdMap table{};
+          for (const uint64_t id: keys) {
+            table.Insert(id);
+          }
+          return table;
+        },
+        [](const DenseIdMap& table, const uint64_t id) {
+          return table.Find(id);
+        }
+      )
+    );
+
+    report(
+      "std::unordered_map",
+      n,
+      measure(
+        ids,
+        queries,
+        repetitions,
+        [](const std::vector<uint64_t>& keys) {
+          std::unordered_map<uint64_t, size_t> table{};
+          for (const uint64_t id: keys) {
+            table.emplace(id, table.size());
+          }
+          return table;
+        },
+        [](const std::unordered_map<uint64_t, size_t>& table,
+           const uint64_t id) { return table.find(id)->second; }
+      )
+    );
+
+    report(
+      "std::map",
+      n,
+      measure(
+        ids,
+        queries,
+        repetitions,
+        [](const std::vector<uint64_t>& keys) {
+          std::map<uint64_t, size_t> table{};
+          for (const uint64_t id: keys) {
+            table.emplace(id, table.size());
+          }
+          return table;
+        },
+        [](const std::map<uint64_t, size_t>& table, const uint64_t id) {
+          return table.find(id)->second;
+        }
+      )
+    );
+  }
+  return 0;
+}
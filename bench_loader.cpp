@@ -0,0 +1,105 @@
+// Edge-list loading throughput, std::ifstream >> (the old solve_from_file
+// loop) against the mmap scanner, in MB/s, then the parallel parser at 1, 2,
+// 4, ... threads up to the hardware concurrency (at least 4).
+//
+// usage: bench_loader [repetitions] [files...]   (default: g500 g1000)
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include "bench_common.h"
+#include "edge_list_reader.h"
+#include "thread_pool.h"
+
+template<typename F>
+double best_of(int runs, F&& f) {
+  double best = 1e300;
+  for (int i = 0; i < runs; ++i) {
+    bench::Timer timer;
+    f();
+    best = std::min(best, timer.Ms());
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  bench::Args args{argc, argv, "bench_loader [repetitions] [files...]"};
+  const int runs = args.Number<int>(1, 20);
+  if (!args.Valid()) {
+    return 1;
+  }
+  std::vector<const char*> files(argv + std::min(argc, 2), argv + argc);
+  if (files.empty()) {
+    files = {"g500", "g1000"};
+  }
+
+  std::printf(
+    "%-10s %10s %12s %12s %12s %12s %8s\n",
+    "file",
+    "MB",
+    "stream ms",
+    "stream MB/s",
+    "mmap ms",
+    "mmap MB/s",
+    "speedup"
+  );
+
+  for (const char* filename: files) {
+    std::ifstream probe(filename, std::ios::binary | std::ios::ate);
+    if (probe.fail()) {
+      std::fprintf(stderr, "%s: Cannot open input file\n", filename);
+      continue;
+    }
+    const double mb = static_cast<double>(probe.tellg()) / (1024.0 * 1024.0);
+
+    size_t checksum = 0;
+
+    const double stream_ms = best_of(runs, [&] {
+      size_t V = 0;
+      checksum += bench::load_text_graph(filename, V).size();
+    });
+
+    const double mmap_ms = best_of(runs, [&] {
+      checksum += read_edge_list<bench::Edge>(filename).edges.size();
+    });
+
+    std::printf(
+      "%-10s %10.2f %12.2f %12.1f %12.2f %12.1f %8.2f\n",
+      filename,
+      mb,
+      stream_ms,
+      mb / (stream_ms / 1000.0),
+      mmap_ms,
+      mb / (mmap_ms / 1000.0),
+      stream_ms / mmap_ms
+    );
+
+    const size_t max_threads =
+      std::max<size_t>(4, std::thread::hardware_concurrency());
+    double one_thread_ms = 0;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+      ThreadPool pool{threads};
+      const double parallel_ms = best_of(runs, [&] {
+        checksum +=
+          read_edge_list<bench::Edge>(filename, true, pool).edges.size();
+      });
+      one_thread_ms = threads == 1 ? parallel_ms : one_thread_ms;
+      std::printf(
+        "%-10s %10s %9zu thr %12.2f %12.1f %8.2f\n",
+        "",
+        "parallel",
+        threads,
+        parallel_ms,
+        mb / (parallel_ms / 1000.0),
+        one_thread_ms / parallel_ms
+      );
+    }
+
+    if (checksum == 0) {
+      std::fprintf(stderr, "%s: no edges\n", filename);
+    }
+  }
+  return 0;
+}
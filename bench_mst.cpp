@@ -0,0 +1,238 @@
+// Scaling report of the MST engines over seeded synthetic graphs: for every
+// generator and V = 1e3, 1e4, ... the generate, build (CsrGraph) and solve
+// phases are timed, with edges/s and the peak RSS after each phase. Each case
+// runs in a forked child, so its peak RSS is its own.
+//
+// Every case has a budget in ns per edge for each solve and in bytes per
+// edge for the peak RSS; a case over budget is marked and the run exits with
+// status 1.
+//
+// usage: bench_mst [max V] [budget scale]
+//        max V defaults to 1e6 (1e7 needs several GB), the budget scale
+//        multiplies every budget (e.g. 4 on a slow or shared machine)
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench_common.h"
+#include "boruvka.h"
+#include "csr_graph.h"
+#include "graph_generators.h"
+#include "kruskal.h"
+#include "thread_pool.h"
+#include "union_find.h"
+
+using Graph_t = CsrGraph<bench::Vertex, bench::Edge>;
+using Edges_t = EdgeList<bench::Edge>;
+
+namespace {
+  /**
+   * @brief Peak resident set of the process so far, in MB
+   */
+  double peak_rss_mb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    // ru_maxrss is in kilobytes on Linux
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+  }
+
+  struct Shape {
+    const char* name;
+    std::function<Edges_t(size_t V)> generate;
+
+    // solve budget in ns per edge, peak RSS budget in bytes per edge
+    double ns_per_edge;
+    double bytes_per_edge;
+
+    // largest V this shape is run at (complete graphs grow as V^2)
+    size_t max_vertices;
+  };
+
+  bool over_budget = false;
+
+  void report(
+    const char* shape,
+    const size_t V,
+    const size_t E,
+    const char* phase,
+    const double ms,
+    const double budget_ms
+  ) {
+    const bool over = budget_ms > 0 && ms > budget_ms;
+    over_budget = over_budget || over;
+    std::printf(
+      "%-12s %10zu %11zu %-24s %10.1f %10.2f %9.1f %s\n",
+      shape,
+      V,
+      E,
+      phase,
+      ms,
+      ms > 0 ? static_cast<double>(E) / ms / 1000.0 : 0.0,
+      peak_rss_mb(),
+      over ? "OVER BUDGET" : ""
+    );
+  }
+
+  /**
+   * @brief Generates, builds and solves one case, false if over budget
+   */
+  bool run_case(const Shape& shape, const size_t V, const double scale) {
+    bench::Timer timer;
+    Edges_t list = shape.generate(V);
+    const size_t E = list.edges.size();
+    report(shape.name, list.vertex_count, E, "generate", timer.Ms(), 0);
+
+    timer.Reset();
+    Graph_t g;
+    for (size_t i = 0; i < list.vertex_count; ++i) {
+      g.InsertVertex(bench::Vertex(i));
+    }
+    g.BuildFromEdgeArray(list.edges.data(), E);
+    list.edges = {};
+    report(shape.name, list.vertex_count, E, "build", timer.Ms(), 0);
+
+    ThreadPool pool{};
+    const std::pair<const char*, std::function<size_t()>> engines[] = {
+      {"kruskal", [&] { return kruskal(g).size(); }},
+      {"kruskal<UnionFind>", [&] { return kruskal<UnionFind>(g).size(); }},
+      {"kruskal(pool)", [&] { return kruskal(g, pool).size(); }},
+      {"filter_kruskal", [&] { return filter_kruskal(g).size(); }},
+      {"boruvka", [&] { return boruvka(g, pool).size(); }},
+    };
+
+    // 1 ms of slack so tiny cases do not trip on timer noise
+    const double budget_ms =
+      shape.ns_per_edge * scale * static_cast<double>(E) / 1e6 + 1.0;
+    for (const auto& [name, solve]: engines) {
+      timer.Reset();
+      const size_t mst_size = solve();
+      const std::string phase = std::string{"solve "} + name;
+      report(
+        shape.name, list.vertex_count, E, phase.c_str(), timer.Ms(), budget_ms
+      );
+      if (mst_size >= list.vertex_count) {
+        std::printf("%s: MST has %zu edges\n", name, mst_size);
+        over_budget = true;
+      }
+    }
+
+    const double rss_budget_mb =
+      shape.bytes_per_edge * scale * static_cast<double>(E) / 1048576 + 32.0;
+    if (peak_rss_mb() > rss_budget_mb) {
+      std::printf(
+        "%-12s %10zu peak RSS %.1f MB over the %.1f MB budget\n",
+        shape.name,
+        list.vertex_count,
+        peak_rss_mb(),
+        rss_budget_mb
+      );
+      over_budget = true;
+    }
+    return !over_budget;
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Args args{argc, argv, "bench_mst [max V] [budget scale]"};
+  const size_t max_vertices = args.Number<size_t>(1, 1000000);
+  const double budget_scale = args.Number<double>(2, 1.0);
+  if (!args.Valid()) {
+    return 1;
+  }
+
+  const auto side = [](const size_t V, const double dimensions) {
+    return static_cast<size_t>(
+      std::round(std::pow(static_cast<double>(V), 1.0 / dimensions))
+    );
+  };
+
+  // budgets: about twice the slowest engine and the peak RSS measured at
+  // V = 1e6 on the development machine
+  const std::vector<Shape> shapes = {
+    {"path+noise",
+     [](size_t V) { return path_with_noise<bench::Edge>(V, 4 * V, 1); },
+     1000,
+     150,
+     max_vertices},
+    {"grid2d",
+     [&](size_t V) { return grid_2d<bench::Edge>(side(V, 2), side(V, 2), 2); },
+     3000,
+     200,
+     max_vertices},
+    {"grid3d",
+     [&](size_t V) {
+       const size_t n = side(V, 3);
+       return grid_3d<bench::Edge>(n, n, n, 3);
+     },
+     2000,
+     200,
+     max_vertices},
+    {"erdos-renyi",
+     [](size_t V) { return erdos_renyi<bench::Edge>(V, 8 * V, 4); },
+     2500,
+     150,
+     max_vertices},
+    {"rmat",
+     [](size_t V) {
+       const auto scale = static_cast<unsigned>(std::ceil(std::log2(V)));
+       return rmat<bench::Edge>(scale, 8 * V, 5);
+     },
+     1500,
+     150,
+     max_vertices},
+    {"complete",
+     [](size_t V) { return complete<bench::Edge>(V, 6); },
+     1000,
+     150,
+     size_t{4000}},
+    {"geometric",
+     [](size_t V) { return geometric<bench::Edge>(V, 16, 7); },
+     1500,
+     150,
+     max_vertices},
+  };
+
+  std::printf(
+    "%-12s %10s %11s %-24s %10s %10s %9s\n",
+    "shape",
+    "V",
+    "E",
+    "phase",
+    "ms",
+    "Medges/s",
+    "peak MB"
+  );
+
+  for (const Shape& shape: shapes) {
+    for (size_t V = 1000; V <= std::min(max_vertices, shape.max_vertices);
+         V *= 10) {
+      std::fflush(stdout);
+      const pid_t child = fork();
+      if (child == 0) {
+        const bool passed = run_case(shape, V, budget_scale);
+        std::fflush(stdout);
+        std::_Exit(passed ? 0 : 1);
+      }
+
+      int status = 0;
+      if (child < 0 || waitpid(child, &status, 0) != child
+          || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        over_budget = true;
+      }
+    }
+  }
+
+  if (over_budget) {
+    std::printf("FAILED: at least one case is over budget\n");
+    return 1;
+  }
+  return 0;
+}
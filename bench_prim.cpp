@@ -0,0 +1,127 @@
+// Kruskal / Prim crossover: the engines on seeded Erdos-Renyi graphs of a
+// fixed vertex count and doubling density E / V, up to the complete graph.
+// Prints the time of each engine per density and the first density at which
+// prim() (binary or 4-ary heap) beats kruskal() and dense_prim() beats both,
+// the figures behind kPrimDensity and kDensePrimFill in prim.h.
+//
+// usage: bench_prim [V] [repetitions]
+//        V defaults to 4096 (the complete graph then has 8.4M edges)
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "bench_common.h"
+#include "csr_graph.h"
+#include "graph_generators.h"
+#include "kruskal.h"
+#include "prim.h"
+
+using Graph_t = CsrGraph<bench::Vertex, bench::Edge>;
+
+namespace {
+  /**
+   * @brief Best of 'runs' timings of 'solve', in ms
+   */
+  double best_ms(const std::function<size_t()>& solve, const int runs) {
+    double best = 1e300;
+    for (int r = 0; r < runs; ++r) {
+      bench::Timer timer;
+      if (solve() == 0) {
+        std::printf("empty MST\n");
+      }
+      best = std::min(best, timer.Ms());
+    }
+    return best;
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Args args{argc, argv, "bench_prim [V] [repetitions]"};
+  const size_t V = args.Number<size_t>(1, 4096);
+  const int runs = args.Number<int>(2, 3);
+  if (!args.Valid()) {
+    return 1;
+  }
+  const size_t pairs = V * (V - 1) / 2;
+
+  std::printf(
+    "%10s %11s %8s %10s %10s %10s %10s  %s\n",
+    "E/V",
+    "E",
+    "fill",
+    "kruskal",
+    "prim",
+    "prim<4>",
+    "dense_prim",
+    "fastest"
+  );
+
+  double prim_density = 0, dense_fill = 0;
+  for (size_t density = 2;; density *= 2) {
+    const bool last = density * V >= pairs;
+    const EdgeList<bench::Edge> list = last
+                                       ? complete<bench::Edge>(V, 19)
+                                       : erdos_renyi<bench::Edge>(
+                                           V, density * V, 19
+                                         );
+    Graph_t g;
+    for (size_t i = 0; i < V; ++i) {
+      g.InsertVertex(bench::Vertex(i));
+    }
+    g.BuildFromEdgeArray(list.edges.data(), list.edges.size());
+
+    const size_t E = list.edges.size();
+    const double fill = static_cast<double>(E) / static_cast<double>(pairs);
+    const std::pair<const char*, double> times[] = {
+      {"kruskal", best_ms([&] { return kruskal(g).size(); }, runs)},
+      {"prim", best_ms([&] { return prim(g).size(); }, runs)},
+      {"prim<4>", best_ms([&] { return prim<4>(g).size(); }, runs)},
+      {"dense_prim", best_ms([&] { return dense_prim(g).size(); }, runs)},
+    };
+    const auto fastest = std::min_element(
+      std::begin(times), std::end(times), [](const auto& a, const auto& b) {
+        return a.second < b.second;
+      }
+    );
+
+    std::printf(
+      "%10.1f %11zu %8.4f %10.2f %10.2f %10.2f %10.2f  %s\n",
+      static_cast<double>(E) / static_cast<double>(V),
+      E,
+      fill,
+      times[0].second,
+      times[1].second,
+      times[2].second,
+      times[3].second,
+      fastest->first
+    );
+
+    if (prim_density == 0
+        && std::min(times[1].second, times[2].second) < times[0].second) {
+      prim_density = static_cast<double>(E) / static_cast<double>(V);
+    }
+    if (dense_fill == 0 && times[3].second < times[1].second
+        && times[3].second < times[2].second) {
+      dense_fill = fill;
+    }
+    if (last) {
+      break;
+    }
+  }
+
+  if (prim_density > 0) {
+    std::printf("prim beats kruskal from E/V = %.1f", prim_density);
+  } else {
+    std::printf("prim never beats kruskal");
+  }
+  std::printf(" (kPrimDensity = %.1f)\n", kPrimDensity);
+  if (dense_fill > 0) {
+    std::printf("dense_prim beats prim from fill = %.4f", dense_fill);
+  } else {
+    std::printf("dense_prim never beats prim");
+  }
+  std::printf(" (kDensePrimFill = %.4f)\n", kDensePrimFill);
+  return 0;
+}
@@ -0,0 +1,229 @@
+/*!
+  \brief  Binary graph file: fixed header + contiguous edge records, loaded
+  by mapping the file (no parsing, no copy)
+
+Layout (native byte order):
+  BinaryGraphHeader   32 bytes: magic, version, index width, weight type,
+                      record size, V, M
+  M x BinaryEdge      { Index id1, id2; Weight weight; }
+
+Implements:
+  write_binary_graph( filename, V, edges )   any range of edges with
+                                             ID1/ID2/Weight
+  BinaryGraph         mapped view with the Size/GetEdges graph surface, so
+                      kruskal() and the other engines read it in place
+*/
+
+#ifndef BINARY_GRAPH_H
+#define BINARY_GRAPH_H
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+#include "mapped_file.h"
+#include "span.h"
+
+/**
+ * @brief File header, followed directly by the edge records
+ */
+struct BinaryGraphHeader {
+  char magic[8];
+  uint32_t version;
+  uint8_t index_width;
+  uint8_t weight_type;
+  uint16_t record_size;
+  uint64_t vertex_count;
+  uint64_t edge_count;
+};
+
+static_assert(sizeof(BinaryGraphHeader) == 32, "header must stay 32 bytes");
+
+inline constexpr char kBinaryGraphMagic[8] = {
+  'M', 'S', 'T', 'G', 'R', 'A', 'P', 'H'
+};
+inline constexpr uint32_t kBinaryGraphVersion = 1;
+
+namespace detail {
+  template<typename Weight>
+  struct BinaryWeightType;
+
+  template<>
+  struct BinaryWeightType<float> : std::integral_constant<uint8_t, 1> {};
+
+  template<>
+  struct BinaryWeightType<double> : std::integral_constant<uint8_t, 2> {};
+
+  template<>
+  struct BinaryWeightType<uint32_t> : std::integral_constant<uint8_t, 3> {};
+
+  template<>
+  struct BinaryWeightType<int32_t> : std::integral_constant<uint8_t, 4> {};
+}
+
+/**
+ * @brief Edge record as stored in the file, usable as a graph Edge
+ */
+template<typename Index, typename WeightType>
+struct BinaryEdge {
+  static_assert(
+    std::is_same_v<Index, uint32_t> || std::is_same_v<Index, uint64_t>,
+    "vertex indices are 32 or 64 bit"
+  );
+
+  Index id1;
+  Index id2;
+  WeightType weight;
+
+  [[nodiscard]] auto ID1() const -> size_t { return id1; }
+
+  [[nodiscard]] auto ID2() const -> size_t { return id2; }
+
+  [[nodiscard]] auto Weight() const -> WeightType { return weight; }
+};
+
+/**
+ * @brief Writes V and 'edges' (anything iterable with ID1/ID2/Weight)
+ */
+template<typename Index, typename Weight, typename Edges>
+auto write_binary_graph(
+  const char* filename,
+  const size_t vertex_count,
+  const Edges& edges
+) -> void {
+  using Record = BinaryEdge<Index, Weight>;
+
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (out.fail()) {
+    throw "Cannot open output file";
+  }
+
+  BinaryGraphHeader header{};
+  std::memcpy(header.magic, kBinaryGraphMagic, sizeof(header.magic));
+  header.version = kBinaryGraphVersion;
+  header.index_width = sizeof(Index);
+  header.weight_type = detail::BinaryWeightType<Weight>::value;
+  header.record_size = sizeof(Record);
+  header.vertex_count = vertex_count;
+  header.edge_count = 0;
+  for (auto it = edges.begin(); it != edges.end(); ++it) {
+    ++header.edge_count;
+  }
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  // records go out in blocks
+  std::vector<Record> block{};
+  block.reserve(size_t{1} << 16);
+  const auto flush = [&] {
+    out.write(
+      reinterpret_cast<const char*>(block.data()),
+      static_cast<std::streamsize>(block.size() * sizeof(Record))
+    );
+    block.clear();
+  };
+
+  for (const auto& edge: edges) {
+    if (edge.ID1() >= vertex_count || edge.ID2() >= vertex_count) {
+      throw "Edge endpoint out of range";
+    }
+    Record record{};
+    record.id1 = static_cast<Index>(edge.ID1());
+    record.id2 = static_cast<Index>(edge.ID2());
+    record.weight = static_cast<Weight>(edge.Weight());
+    block.push_back(record);
+    if (block.size() == block.capacity()) {
+      flush();
+    }
+  }
+  flush();
+
+  if (out.fail()) {
+    throw "Cannot write output file";
+  }
+}
+
+/**
+ * @brief Reads only the header of a binary graph file
+ */
+inline auto read_binary_graph_header(const char* filename)
+  -> BinaryGraphHeader {
+  std::ifstream in(filename, std::ios::binary);
+  if (in.fail()) {
+    throw "Cannot open input file";
+  }
+
+  BinaryGraphHeader header{};
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in || std::memcmp(header.magic, kBinaryGraphMagic, 8) != 0) {
+    throw "Not a binary graph file";
+  }
+  return header;
+}
+
+/**
+ * @class BinaryGraph
+ * @brief Read-only graph over a mapped binary graph file
+ *
+ * GetEdges() points straight into the mapping. The constructor reads every
+ * record once to check its endpoints, since the engines index union-find by
+ * them unchecked. Index and WeightType must match the file's header.
+ */
+template<typename Index = uint32_t, typename WeightType = float>
+class BinaryGraph {
+public:
+
+  typedef BinaryEdge<Index, WeightType> Edge;
+
+  /**
+   * @brief Maps 'filename', checks the header against Index and WeightType
+   * and every endpoint against the vertex count
+   */
+  explicit BinaryGraph(const char* filename): file{filename}, header{} {
+    if (file.size() < sizeof(header)) {
+      throw "Not a binary graph file";
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kBinaryGraphMagic, 8) != 0
+        || header.version != kBinaryGraphVersion) {
+      throw "Not a binary graph file";
+    }
+    if (header.index_width != sizeof(Index)
+        || header.weight_type != detail::BinaryWeightType<WeightType>::value
+        || header.record_size != sizeof(Edge)) {
+      throw "Binary graph has a different index width or weight type";
+    }
+    // divide rather than multiply, a huge edge_count must not wrap around
+    const size_t body = file.size() - sizeof(header);
+    if (body % sizeof(Edge) != 0 || header.edge_count != body / sizeof(Edge)) {
+      throw "Binary graph file is truncated";
+    }
+
+    for (const Edge& edge: GetEdges()) {
+      if (edge.ID1() >= header.vertex_count
+          || edge.ID2() >= header.vertex_count) {
+        throw "Edge endpoint out of range";
+      }
+    }
+  }
+
+  [[nodiscard]] auto Size() const -> size_t { return header.vertex_count; }
+
+  /**
+   * @brief Every edge, in file order, without copying
+   */
+  [[nodiscard]] auto GetEdges() const -> Span<const Edge> {
+    return Span<const Edge>{
+      reinterpret_cast<const Edge*>(file.data() + sizeof(header)),
+      header.edge_count
+    };
+  }
+
+private:
+
+  MappedFile file;
+  BinaryGraphHeader header;
+};
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef BORUVKA_H
+#define BORUVKA_H
+
+#include "kruskal.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Parallel Boruvka MST on the given pool
+ *
+ * Every round finds the lightest outgoing edge of each component in parallel
+ * over the remaining edges, hooks components along those edges and drops the
+ * edges that became internal. Edges are ordered by (weight, input position),
+ * the same total order kruskal() visits them in, so the MST is unique and
+ * the returned vector equals kruskal()'s edge for edge.
+ */
+template<typename GraphType>
+auto boruvka(const GraphType& graph, ThreadPool& pool)
+  -> std::vector<typename GraphType::Edge> {
+  using Edge = typename GraphType::Edge;
+  using Key = detail::SortKeyOf<Edge>;
+
+  constexpr size_t none = std::numeric_limits<size_t>::max();
+
+  const size_t size = graph.Size();
+  const size_t chunks = pool.Size();
+
+  const std::vector<Edge> edges{
+    graph.GetEdges().begin(), graph.GetEdges().end()
+  };
+
+  std::vector<Key> keys(edges.size());
+  pool.ParallelFor(edges.size(), [&](size_t begin, size_t end, size_t) {
+    for (size_t i = begin; i < end; ++i) {
+      keys[i] = detail::sort_key(edges[i]);
+    }
+  });
+
+  const auto lighter = [&](const size_t a, const size_t b) {
+    return keys[a] < keys[b] || (!(keys[b] < keys[a]) && a < b);
+  };
+
+  // component label of every vertex, always a root component
+  std::vector<size_t> component(size);
+  for (size_t v = 0; v < size; ++v) {
+    component[v] = v;
+  }
+
+  // lightest outgoing edge per component (edge index, 'none' if unknown)
+  const std::unique_ptr<std::atomic<size_t>[]> lightest{
+    new std::atomic<size_t>[size]
+  };
+
+  // hook target of every component for the current round
+  std::vector<size_t> parent(size);
+
+  // edges that still connect two different components
+  std::vector<size_t> active(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    active[i] = i;
+  }
+
+  std::vector<std::vector<size_t>> chunk_buffers(chunks);
+  std::vector<size_t> picked{};
+
+  while (!active.empty()) {
+    pool.ParallelFor(size, [&](size_t begin, size_t end, size_t) {
+      for (size_t c = begin; c < end; ++c) {
+        lightest[c].store(none, std::memory_order_relaxed);
+      }
+    });
+
+    // lock-free write-min of the lightest edge on both endpoint components
+    pool.ParallelFor(active.size(), [&](size_t begin, size_t end, size_t) {
+      const auto offer = [&](const size_t c, const size_t e) {
+        size_t current = lightest[c].load(std::memory_order_relaxed);
+        while ((current == none || lighter(e, current))
+               && !lightest[c].compare_exchange_weak(
+                 current, e, std::memory_order_relaxed
+               )) {
+        }
+      };
+
+      for (size_t i = begin; i < end; ++i) {
+        const size_t e = active[i];
+        const size_t c1 = component[edges[e].ID1()];
+        const size_t c2 = component[edges[e].ID2()];
+        if (c1 != c2) {
+          offer(c1, e);
+          offer(c2, e);
+        }
+      }
+    });
+
+    // hook every component onto the one across its lightest edge, a pair of
+    // components choosing the same edge is the only possible cycle
+    pool.ParallelFor(size, [&](size_t begin, size_t end, size_t chunk) {
+      std::vector<size_t>& accepted = chunk_buffers[chunk];
+      accepted.clear();
+
+      for (size_t c = begin; c < end; ++c) {
+        parent[c] = c;
+        const size_t e = lightest[c].load(std::memory_order_relaxed);
+        if (e == none) {
+          continue;
+        }
+
+        const size_t c1 = component[edges[e].ID1()];
+        const size_t other = c1 == c ? component[edges[e].ID2()] : c1;
+        const bool mutual =
+          lightest[other].load(std::memory_order_relaxed) == e;
+
+        if (!mutual || c < other) {
+          accepted.push_back(e);
+        }
+        if (!mutual || c > other) {
+          parent[c] = other;
+        }
+      }
+    });
+
+    for (const std::vector<size_t>& accepted: chunk_buffers) {
+      picked.insert(picked.end(), accepted.begin(), accepted.end());
+    }
+
+    // contract: resolve every hook chain to its root, compressing as we go
+    for (size_t c = 0; c < size; ++c) {
+      size_t root = c;
+      while (parent[root] != root) {
+        root = parent[root];
+      }
+      for (size_t next = c; parent[next] != root && next != root;) {
+        next = std::exchange(parent[next], root);
+      }
+    }
+
+    pool.ParallelFor(size, [&](size_t begin, size_t end, size_t) {
+      for (size_t v = begin; v < end; ++v) {
+        component[v] = parent[component[v]];
+      }
+    });
+
+    // keep only edges that still cross components
+    pool.ParallelFor(
+      active.size(),
+      [&](size_t begin, size_t end, size_t chunk) {
+        std::vector<size_t>& kept = chunk_buffers[chunk];
+        kept.clear();
+        for (size_t i = begin; i < end; ++i) {
+          const Edge& edge = edges[active[i]];
+          if (component[edge.ID1()] != component[edge.ID2()]) {
+            kept.push_back(active[i]);
+          }
+        }
+      }
+    );
+
+    active.clear();
+    for (const std::vector<size_t>& kept: chunk_buffers) {
+      active.insert(active.end(), kept.begin(), kept.end());
+    }
+  }
+
+  // kruskal() reports edges in the order it accepts them
+  std::sort(picked.begin(), picked.end(), lighter);
+
+  std::vector<Edge> mst{};
+  mst.reserve(picked.size());
+  for (const size_t e: picked) {
+    mst.push_back(edges[e]);
+  }
+  return mst;
+}
+
+/**
+ * @brief Parallel Boruvka MST on 'threads' threads (0 means all cores)
+ */
+template<typename GraphType>
+auto boruvka(const GraphType& graph, const size_t threads = 0)
+  -> std::vector<typename GraphType::Edge> {
+  ThreadPool pool{threads};
+  return boruvka(graph, pool);
+}
+
+#endif
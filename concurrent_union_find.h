@@ -0,0 +1,175 @@
+/*!
+  \brief  Lock-free disjoint sets for concurrent use (DisjointSets interface)
+
+Implements:
+  ctor (size)
+  Make( id )      initialize - NOT thread safe, call before sharing
+  Join( id,id )   join 2 sets - lock free
+  GetRepresentative( id )   wait free
+  SameSet( id,id )          linearizable connectivity query
+
+Rationale:
+  elements of the set are assumed to be contiguous 0,1,2,3,....
+  Parents are atomics. A root is only ever linked under a root with a
+  smaller index, with one CAS that fails if the root was linked in the
+  meantime, so parent indices strictly decrease along every path and no
+  cycle can form. Finds halve the path with a single CAS attempt per step
+  (a lost race just skips the shortcut), so they finish in a bounded number
+  of steps whatever the other threads do.
+*/
+
+#ifndef CONCURRENT_UNION_FIND_H
+#define CONCURRENT_UNION_FIND_H
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+/**
+ * @class ConcurrentUnionFind
+ * @brief Union-find whose Join/GetRepresentative may race from any thread
+ */
+class ConcurrentUnionFind {
+public:
+
+  /**
+   * @brief Constructor to create a disjoint list with a fixed inner capacity
+   */
+  explicit ConcurrentUnionFind(size_t capacity);
+
+  ConcurrentUnionFind(const ConcurrentUnionFind&) = delete;
+  ConcurrentUnionFind& operator=(const ConcurrentUnionFind&) = delete;
+  ConcurrentUnionFind(ConcurrentUnionFind&&) = delete;
+  ConcurrentUnionFind& operator=(ConcurrentUnionFind&&) = delete;
+
+  /**
+   * @brief Creates a new representative with ID of the current size
+   */
+  auto Make() -> void;
+
+  /**
+   * @brief Joins the two represntatives together, the smaller index wins
+   */
+  auto Join(size_t id1, size_t id2) -> void;
+
+  /**
+   * @brief Gets representative index from the given id (halves the path)
+   *
+   * Under concurrent joins the result may already be stale when it returns,
+   * use SameSet to compare two elements
+   */
+  [[nodiscard]] auto GetRepresentative(size_t id) const -> size_t;
+
+  /**
+   * @brief Whether both ids were in the same set at some instant of the call
+   */
+  [[nodiscard]] auto SameSet(size_t id1, size_t id2) const -> bool;
+
+  /**
+   * @brief Raw index into the parent array
+   */
+  [[nodiscard]] auto operator[](size_t id) const -> size_t;
+
+  friend auto operator<<(std::ostream& os, const ConcurrentUnionFind& uf)
+    -> std::ostream&;
+
+private:
+
+  // current size
+  size_t size{0};
+
+  // capacity - NOT growing, provided as ctor arg
+  size_t capacity{0};
+
+  // parent links, roots point to themselves
+  std::unique_ptr<std::atomic<size_t>[]> parents{nullptr};
+};
+
+inline ConcurrentUnionFind::ConcurrentUnionFind(const size_t capacity):
+    size(0), capacity(capacity), parents{new std::atomic<size_t>[capacity]} {}
+
+inline auto ConcurrentUnionFind::Make() -> void {
+  parents[size].store(size, std::memory_order_relaxed);
+  ++size;
+}
+
+inline auto ConcurrentUnionFind::Join(const size_t id1, const size_t id2)
+  -> void {
+  size_t rep1 = id1;
+  size_t rep2 = id2;
+
+  while (true) {
+    rep1 = GetRepresentative(rep1);
+    rep2 = GetRepresentative(rep2);
+
+    if (rep1 == rep2) {
+      return;
+    }
+    if (rep1 < rep2) {
+      std::swap(rep1, rep2);
+    }
+
+    // link the larger root under the smaller one, fails if it stopped
+    // being a root since we looked
+    size_t expected = rep1;
+    if (parents[rep1].compare_exchange_strong(
+          expected, rep2, std::memory_order_acq_rel
+        )) {
+      return;
+    }
+  }
+}
+
+inline auto ConcurrentUnionFind::GetRepresentative(size_t id) const
+  -> size_t {
+  size_t parent = parents[id].load(std::memory_order_acquire);
+
+  while (parent != id) {
+    const size_t grandparent = parents[parent].load(std::memory_order_acquire);
+
+    // path halving, losing the race only loses the shortcut
+    if (grandparent != parent) {
+      size_t expected = parent;
+      parents[id].compare_exchange_weak(
+        expected, grandparent, std::memory_order_acq_rel
+      );
+    }
+
+    id = parent;
+    parent = grandparent;
+  }
+  return id;
+}
+
+inline auto ConcurrentUnionFind::SameSet(size_t id1, size_t id2) const
+  -> bool {
+  while (true) {
+    id1 = GetRepresentative(id1);
+    id2 = GetRepresentative(id2);
+
+    if (id1 == id2) {
+      return true;
+    }
+
+    // id1 still a root means the two sets were distinct at this point
+    if (parents[id1].load(std::memory_order_acquire) == id1) {
+      return false;
+    }
+  }
+}
+
+inline auto ConcurrentUnionFind::operator[](const size_t id) const -> size_t {
+  return parents[id].load(std::memory_order_acquire);
+}
+
+inline auto operator<<(std::ostream& os, const ConcurrentUnionFind& uf)
+  -> std::ostream& {
+  for (size_t i = 0; i < uf.size; ++i) {
+    os << i << ":  parent " << uf[i] << " (representative "
+       << uf.GetRepresentative(i) << ")\n";
+  }
+  return os;
+}
+
+#endif
@@ -0,0 +1,185 @@
+/*!
+  \brief  Compressed sparse row (CSR) representation of a directed graph.
+
+Same surface as Graph (graph.h):
+  InsertEdge
+  InsertVertex
+  BuildFromEdgeArray
+  GetVertex
+  GetEdges        contiguous span over every edge
+  GetOutEdges     contiguous span over the edges leaving a vertex, O(1)
+  Size
+  Print
+
+Rationale:
+  vertex IDs are assumed contiguous 0,1,2,3,.... (as in DisjointSets), so a
+  vertex ID is directly an index into the offset array. Edges are kept in one
+  array grouped by ID1, so the global edge list and every adjacency list are
+  the same memory. The arrays are built in a single counting pass by
+  Finalize() (BuildFromEdgeArray finalizes on its own); edges inserted with
+  InsertEdge are buffered until then.
+*/
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "span.h"
+
+template<typename VertexType, typename EdgeType>
+class CsrGraph {
+public:
+
+  // the usual type-getters
+  typedef VertexType Vertex;
+  typedef EdgeType Edge;
+
+  CsrGraph(): vertices(), offsets(1, 0), edges(), pending() {}
+
+  /**
+   * @brief Buffers an edge, visible after the next Finalize()
+   */
+  auto InsertEdge(const EdgeType& e) -> void {
+    Reserve(std::max(e.ID1(), e.ID2()) + 1);
+    pending.push_back(e);
+  }
+
+  /**
+   * @brief Makes sure the vertex (and every ID below it) exists
+   */
+  auto InsertVertex(const VertexType& v) -> void { Reserve(v.ID() + 1); }
+
+  /**
+   * @brief Appends 'size' edges and builds the CSR arrays in one pass
+   */
+  auto BuildFromEdgeArray(const EdgeType* array, const size_t size) -> void {
+    size_t vertex_count = vertices.size();
+    for (size_t i = 0; i < size; ++i) {
+      vertex_count =
+        std::max(vertex_count, std::max(array[i].ID1(), array[i].ID2()) + 1);
+    }
+    Reserve(vertex_count);
+
+    pending.insert(pending.end(), array, array + size);
+    Finalize();
+  }
+
+  /**
+   * @brief Merges buffered edges into the CSR arrays (counting sort by ID1)
+   */
+  auto Finalize() -> void {
+    if (IsFinalized()) {
+      return;
+    }
+
+    const size_t vertex_count = vertices.size();
+
+    // degree count, existing edges are already grouped so reuse their offsets
+    std::vector<size_t> next(vertex_count + 1, 0);
+    for (size_t v = 0; v + 1 < offsets.size(); ++v) {
+      next[v + 1] = offsets[v + 1] - offsets[v];
+    }
+    for (const EdgeType& e: pending) {
+      ++next[e.ID1() + 1];
+    }
+    for (size_t v = 0; v < vertex_count; ++v) {
+      next[v + 1] += next[v];
+    }
+
+    std::vector<size_t> new_offsets{next};
+    std::vector<EdgeType> grouped(next[vertex_count]);
+
+    // stable scatter: old edges first, then new ones in insertion order
+    for (const EdgeType& e: edges) {
+      grouped[next[e.ID1()]++] = e;
+    }
+    for (const EdgeType& e: pending) {
+      grouped[next[e.ID1()]++] = e;
+    }
+
+    offsets = std::move(new_offsets);
+    edges = std::move(grouped);
+    pending.clear();
+    pending.shrink_to_fit();
+  }
+
+  /**
+   * @brief Whether every inserted edge is visible through the getters
+   */
+  [[nodiscard]] auto IsFinalized() const -> bool {
+    return pending.empty() && offsets.size() == vertices.size() + 1;
+  }
+
+  [[nodiscard]] auto GetVertex(size_t id) const -> const VertexType& {
+    if (id < vertices.size()) {
+      return vertices[id];
+    }
+    throw "cannot find node in the graph";
+  }
+
+  /**
+   * @brief Every edge, grouped by ID1
+   */
+  [[nodiscard]] auto GetEdges() const -> Span<const EdgeType> {
+    CheckFinalized();
+    return Span<const EdgeType>{edges};
+  }
+
+  [[nodiscard]] auto GetOutEdges(size_t id) const -> Span<const EdgeType> {
+    CheckFinalized();
+    if (id >= vertices.size()) {
+      throw "cannot find node in the graph";
+    }
+    return Span<const EdgeType>{
+      edges.data() + offsets[id], offsets[id + 1] - offsets[id]
+    };
+  }
+
+  [[nodiscard]] auto GetOutEdges(const VertexType& v) const
+    -> Span<const EdgeType> {
+    return GetOutEdges(v.ID());
+  }
+
+  [[nodiscard]] auto Size() const -> size_t { return vertices.size(); }
+
+  friend auto operator<<(std::ostream& os, const CsrGraph& g)
+    -> std::ostream& {
+    for (size_t v = 0; v < g.Size(); ++v) {
+      os << "Vertex " << g.vertices[v].ID() << std::endl;
+      for (const EdgeType& e: g.GetOutEdges(v)) {
+        os << "\t"
+           << " (" << e.ID1() << " -> " << e.ID2() << ")" << std::endl;
+      }
+    }
+    return os;
+  }
+
+private:
+
+  auto Reserve(const size_t vertex_count) -> void {
+    while (vertices.size() < vertex_count) {
+      vertices.emplace_back(vertices.size());
+    }
+  }
+
+  auto CheckFinalized() const -> void {
+    if (!IsFinalized()) {
+      throw "graph is not finalized";
+    }
+  }
+
+  // vertex objects indexed by ID
+  std::vector<VertexType> vertices;
+
+  // edges of vertex v are edges[offsets[v] .. offsets[v + 1])
+  std::vector<size_t> offsets;
+
+  // every edge, grouped by ID1
+  std::vector<EdgeType> edges;
+
+  // edges inserted since the last Finalize()
+  std::vector<EdgeType> pending;
+};
+
+#endif
@@ -1,13 +1,14 @@
 #include "disjoint_sets.h"
 #include <iostream>
 #include <utility>
+#include "mst_stats.h"
 
 // class Node implementation
-Node::Node(size_t value): next{nullptr}, value(value) {}
+Node::Node(size_t value): next{kNone}, value(value) {}
 
-Node* Node::get_next() { return next; }
+size_t Node::get_next() const { return next; }
 
-auto Node::set_next(Node* new_next) -> void { next = std::move(new_next); }
+auto Node::set_next(size_t new_next) -> void { next = new_next; }
 
 auto Node::get_value() const -> size_t { return value; }
 
@@ -18,34 +19,28 @@ auto operator<<(std::ostream& os, const Node& node) -> std::ostream& {
 
 Head::Head() = default;
 
-Head::~Head() {
-  for (size_t i = 0; i < length; ++i) {
-    delete std::exchange(first, first->get_next());
-  }
-}
-
 auto Head::size() const -> size_t { return length; }
 
-auto Head::get_first() const -> Node* { return first; }
+auto Head::get_first() const -> size_t { return first; }
 
-auto Head::get_last() const -> Node* { return last; }
+auto Head::get_last() const -> size_t { return last; }
 
 auto Head::init(size_t value) -> void {
-  first = new Node{value};
+  first = value;
   last = first;
   length = 1;
 }
 
-auto Head::join(Head& head2) -> void {
+auto Head::join(Head& head2, Node* nodes) -> void {
   length += std::exchange(head2.length, 0);
 
-  if (length == 0) {
-    first = std::exchange(head2.first, nullptr);
+  if (last == Node::kNone) {
+    first = std::exchange(head2.first, Node::kNone);
   } else {
-    last->set_next(std::exchange(head2.first, nullptr));
+    nodes[last].set_next(std::exchange(head2.first, Node::kNone));
   }
 
-  last = std::exchange(head2.last, nullptr);
+  last = std::exchange(head2.last, Node::kNone);
 }
 
 auto operator<<(std::ostream& os, const Head& head) -> std::ostream& {
@@ -58,12 +53,14 @@ DisjointSets::DisjointSets(const size_t capacity):
     size(0),
     capacity(capacity),
     representatives{new size_t[capacity]{}},
-    heads{new Head[capacity]{}} {}
+    heads{new Head[capacity]{}},
+    nodes{new Node[capacity]} {}
 
 auto DisjointSets::Make() -> void {
   // if (size == capacity) {
   //   throw "DisjointSets::Make(...) out of space";
   // }
+  nodes[size] = Node{size};
   heads[size].init(size);
   representatives[size] = size;
   ++size;
@@ -81,41 +78,126 @@ auto DisjointSets::Join(const size_t id1, const size_t id2) -> void {
     std::swap(rep1, rep2);
   }
 
-  Node* current = heads[rep2].get_last();
-  heads[rep2].join(heads[rep1]);
+  MST_STATS_ADD(nodes_relabelled, heads[rep1].size());
 
-  current = current->get_next();
+  size_t current = heads[rep2].get_last();
+  heads[rep2].join(heads[rep1], nodes.get());
+
+  current = nodes[current].get_next();
 
   // update representative refs
-  while (current) {
-    representatives[current->get_value()] = rep2;
-    current = current->get_next();
+  while (current != Node::kNone) {
+    representatives[nodes[current].get_value()] = rep2;
+    current = nodes[current].get_next();
   }
 
   std::ignore = GetRepresentative(id1);
   std::ignore = GetRepresentative(id2);
 }
 
-auto DisjointSets::GetRepresentative(const size_t id) const -> size_t {
-  if (representatives[id] != id) {
-    representatives[id] = GetRepresentative(representatives[id]);
+auto DisjointSets::GetRepresentative(size_t id) const -> size_t {
+  MST_STATS_FIND_PATH(path);
+  size_t root = id;
+  while (representatives[root] != root) {
+    root = representatives[root];
+    MST_STATS_FIND_STEP(path);
   }
-  return representatives[id];
+
+  // same compression the recursive form did: the whole path to the root
+  while (id != root) {
+    id = std::exchange(representatives[id], root);
+  }
+  return root;
 }
 
 auto DisjointSets::operator[](const size_t id) const -> size_t {
   return representatives[id];
 }
 
+namespace {
+  // queries in flight: far enough ahead to hide a miss, close enough that
+  // the lines are still cached when the query is answered
+  constexpr size_t kPrefetchDistance = 16;
+
+  inline auto prefetch(const size_t* address) -> void {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    static_cast<void>(address);
+#endif
+  }
+}
+
+// a find reads the slot of its id and then the slot that names, which after
+// Join's relabelling is the root's own. The two loads are pipelined: the
+// query 2 * kPrefetchDistance ahead has its slot prefetched, by the time it
+// is kPrefetchDistance ahead that slot has arrived and the slot it names is
+// prefetched, so both are cached when the find runs
+auto DisjointSets::GetRepresentatives(
+  const Span<const size_t> ids,
+  const Span<size_t> out
+) const -> void {
+  const size_t* const table = representatives.get();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (i + 2 * kPrefetchDistance < ids.size()) {
+      prefetch(&table[ids[i + 2 * kPrefetchDistance]]);
+    }
+    if (i + kPrefetchDistance < ids.size()) {
+      prefetch(&table[table[ids[i + kPrefetchDistance]]]);
+    }
+    out[i] = GetRepresentative(ids[i]);
+  }
+}
+
+auto DisjointSets::Connected(
+  const Span<const std::pair<size_t, size_t>> pairs,
+  const Span<uint8_t> out
+) const -> void {
+  const size_t* const table = representatives.get();
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    if (i + 2 * kPrefetchDistance < pairs.size()) {
+      const auto [u, v] = pairs[i + 2 * kPrefetchDistance];
+      prefetch(&table[u]);
+      prefetch(&table[v]);
+    }
+    if (i + kPrefetchDistance < pairs.size()) {
+      const auto [u, v] = pairs[i + kPrefetchDistance];
+      prefetch(&table[table[u]]);
+      prefetch(&table[table[v]]);
+    }
+    out[i] = GetRepresentative(pairs[i].first)
+          == GetRepresentative(pairs[i].second);
+  }
+}
+
+auto DisjointSets::GetComponents() const -> ComponentLabels {
+  // Join relabels every moved node, so representatives[id] is already the
+  // root; label_of maps a root to its dense label
+  constexpr size_t unlabelled = static_cast<size_t>(-1);
+  std::vector<size_t> label_of(size, unlabelled);
+
+  ComponentLabels components{std::vector<size_t>(size), {}};
+  for (size_t id = 0; id < size; ++id) {
+    const size_t root = GetRepresentative(id);
+    if (label_of[root] == unlabelled) {
+      label_of[root] = components.sizes.size();
+      components.sizes.push_back(0);
+    }
+    components.labels[id] = label_of[root];
+    ++components.sizes[label_of[root]];
+  }
+  return components;
+}
+
 auto operator<<(std::ostream& os, const DisjointSets& ds) -> std::ostream& {
   for (size_t i = 0; i < ds.size; ++i) {
     os << i << ":  ";
     Head* p_head = &ds.heads[i];
     os << *p_head;
-    Node* p_node = p_head->get_first();
-    while (p_node) {
-      os << *p_node;
-      p_node = p_node->get_next();
+    size_t node = p_head->get_first();
+    while (node != Node::kNone) {
+      os << ds.nodes[node];
+      node = ds.nodes[node].get_next();
     }
     os << "NULL (representative " << ds.representatives[i] << ")\n";
   }
@@ -5,45 +5,62 @@
 Implements:
   ctor (size)
   Make( id )      initialize
+  Reset()         forget every element, keep the storage
   Join( id,id )   join 2 sets
   GetRepresentative( id )
+  GetRepresentatives( ids, out )   batched, prefetched lookups
+  Connected( pairs, out )          batched "same set?" queries
+  GetComponents()                  dense labels and sizes in one pass
 
 Rationale:
   elements of the set are assumed to be contiguous 0,1,2,3,....
+  Node i is element i, so every node lives in one array allocated by the
+  ctor and the lists link by index: construction and destruction are a
+  fixed number of allocations, and Join walks nodes in a single block.
 */
 
 #ifndef DISJOINT_SETS_H
 #define DISJOINT_SETS_H
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <utility>
+#include <vector>
+#include "span.h"
 
 // add Head and Node
 
 /**
  * @class Node
- * @brief Node for use in disjointed set
+ * @brief Node for use in disjointed set, linked by index into the arena of
+ * its DisjointSets
  *
  */
 class Node final {
 public:
 
+  /**
+   * @brief next of the last node in a list
+   */
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
   /**
    * @brief Constructor
    *
    * @param value Repr ID
    */
-  Node(size_t value);
+  Node(size_t value = 0);
 
   /**
-   * @brief Gets next node in list
+   * @brief Gets index of the next node in list, kNone at the end
    */
-  [[nodiscard]] Node* get_next();
+  [[nodiscard]] size_t get_next() const;
 
   /**
-   * @brief Sets next node in list
+   * @brief Sets index of the next node in list
    */
-  void set_next(Node* new_next);
+  void set_next(size_t new_next);
 
   /**
    * @brief Gets inner value / repr
@@ -58,9 +75,9 @@ public:
 private:
 
   /**
-   * @brief Next pointer
+   * @brief Next index
    */
-  Node* next;
+  size_t next;
 
   /**
    * @brief Value
@@ -70,7 +87,8 @@ private:
 
 /**
  * @class Head
- * @brief Head list for a linked list of representatives
+ * @brief Head list for a linked list of representatives, the nodes live in
+ * the arena passed to join
  *
  */
 class Head final {
@@ -82,9 +100,9 @@ public:
   Head();
 
   /**
-   * @brief Destructor
+   * @brief Destructor, the arena owns the nodes
    */
-  ~Head();
+  ~Head() = default;
 
   /**
    * @brief Deleted move cosntructor
@@ -112,24 +130,24 @@ public:
   [[nodiscard]] auto size() const -> size_t;
 
   /**
-   * @brief Gets first node in list
+   * @brief Gets index of first node in list, Node::kNone if empty
    */
-  [[nodiscard]] auto get_first() const -> Node*;
+  [[nodiscard]] auto get_first() const -> size_t;
 
   /**
-   * @brief Gest last node in list
+   * @brief Gets index of last node in list, Node::kNone if empty
    */
-  [[nodiscard]] auto get_last() const -> Node*;
+  [[nodiscard]] auto get_last() const -> size_t;
 
   /**
-   * @brief Initialises list to have 1 node with represenative 'value'
+   * @brief Initialises list to have 1 node, the one at index 'value'
    */
   auto init(size_t value) -> void;
 
   /**
-   * @brief Gives head to self
+   * @brief Gives head to self, linking through the 'nodes' arena
    */
-  auto join(Head& head2) -> void;
+  auto join(Head& head2, Node* nodes) -> void;
 
   /**
    * @brief Prints to character ostream
@@ -139,8 +157,17 @@ public:
 private:
 
   size_t length{0};
-  Node* first{nullptr};
-  Node* last{nullptr};
+  size_t first{Node::kNone};
+  size_t last{Node::kNone};
+};
+
+/**
+ * @brief Dense component numbering: labels[id] in 0..sizes.size()-1, in
+ * order of each component's first element
+ */
+struct ComponentLabels {
+  std::vector<size_t> labels;
+  std::vector<size_t> sizes;
 };
 
 /**
@@ -175,11 +202,20 @@ public:
    */
   DisjointSets& operator=(DisjointSets&&) = delete;
 
+  // storage per element: representative, list head and list node
+  static constexpr size_t kElementBytes =
+    sizeof(size_t) + sizeof(Head) + sizeof(Node);
+
   /**
    * @brief Creates a new representative with ID of the current size
    */
   auto Make() -> void;
 
+  /**
+   * @brief Forgets every element, the next Make() creates ID 0 again
+   */
+  auto Reset() -> void { size = 0; }
+
   /**
    * @brief Joins the two represntatives together
    */
@@ -195,6 +231,29 @@ public:
    */
   [[nodiscard]] auto operator[](size_t id) const -> size_t;
 
+  /**
+   * @brief out[i] = GetRepresentative(ids[i]), both table loads of each find
+   * are prefetched a few queries ahead so their cache misses overlap
+   * (out.size() >= ids.size())
+   */
+  auto GetRepresentatives(Span<const size_t> ids, Span<size_t> out) const
+    -> void;
+
+  /**
+   * @brief out[i] = 1 if pairs[i] are in the same set, else 0, prefetched
+   * like GetRepresentatives (out.size() >= pairs.size())
+   */
+  auto Connected(
+    Span<const std::pair<size_t, size_t>> pairs,
+    Span<uint8_t> out
+  ) const -> void;
+
+  /**
+   * @brief Label and size of every component from one pass over the
+   * representative table, the lists are not walked
+   */
+  [[nodiscard]] auto GetComponents() const -> ComponentLabels;
+
   /**
    * @brief Prints self to character ostream
    */
@@ -214,6 +273,9 @@ private:
 
   // lists' heads
   std::unique_ptr<Head[]> heads{nullptr};
+
+  // arena of list nodes, node i holds element i
+  std::unique_ptr<Node[]> nodes{nullptr};
 };
 
 #endif
@@ -0,0 +1,88 @@
+/*!
+  \brief  Reader for the edge statements of the .dot inputs (g5.dot, ...)
+
+Implements:
+  parse_dot_edges( begin, end )   every "u--v [label="w"];" (or u->v) line
+  read_dot_edges( filename )
+
+Rationale:
+  only the subset of dot the inputs use: one edge per line, numeric vertex
+  names, the weight in the label (1 when there is no label). V is one past
+  the largest vertex ID. Each edge is stored once, as written.
+*/
+
+#ifndef DOT_READER_H
+#define DOT_READER_H
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "edge_list_reader.h"
+#include "mapped_file.h"
+
+/**
+ * @brief Parses the edge lines of a dot graph held in [begin, end)
+ */
+template<typename Edge>
+auto parse_dot_edges(const char* begin, const char* end) -> EdgeList<Edge> {
+  using Weight = std::decay_t<decltype(std::declval<const Edge&>().Weight())>;
+
+  const auto is_digit = [](const char c) { return c >= '0' && c <= '9'; };
+
+  EdgeList<Edge> list{0, {}};
+
+  for (const char* line = begin; line < end;) {
+    const char* const eol = std::find(line, end, '\n');
+
+    // "--" (undirected) or "->" (directed), both read as one edge
+    const char* arrow = line;
+    while (arrow + 1 < eol
+           && !(arrow[0] == '-' && (arrow[1] == '-' || arrow[1] == '>'))) {
+      ++arrow;
+    }
+
+    if (arrow + 1 < eol) {
+      const char* const first = std::find_if(line, arrow, is_digit);
+      const char* const second = std::find_if(arrow + 2, eol, is_digit);
+
+      size_t u, v;
+      detail::TextScanner left{first, arrow};
+      detail::TextScanner right{second, eol};
+      if (first == arrow || !left.ReadUnsigned(u) || !right.ReadUnsigned(v)) {
+        throw "Malformed dot edge";
+      }
+
+      double w = 1;
+      const char* const label = std::search(
+        second, eol, "label=", "label=" + std::strlen("label=")
+      );
+      if (label != eol) {
+        const char* number = label + std::strlen("label=");
+        number += number != eol && *number == '"';
+        detail::TextScanner weight{number, eol};
+        if (!weight.ReadNumber(w)) {
+          throw "Malformed dot label";
+        }
+      }
+
+      list.edges.emplace_back(u, v, static_cast<Weight>(w));
+      list.vertex_count = std::max(list.vertex_count, std::max(u, v) + 1);
+    }
+
+    line = eol + 1;
+  }
+
+  return list;
+}
+
+/**
+ * @brief Maps 'filename' and parses it, see parse_dot_edges
+ */
+template<typename Edge>
+auto read_dot_edges(const char* filename) -> EdgeList<Edge> {
+  const MappedFile file{filename};
+  return parse_dot_edges<Edge>(file.data(), file.data() + file.size());
+}
+
+#endif
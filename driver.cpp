@@ -1,7 +1,16 @@
+#include <atomic>
+#include <cstddef> //offsetof
 #include <cstdio> //sscanf
+#include <cstring>
+#include <stdexcept>
 #include <vector>
+#include "binary_graph.h"
+#include "boruvka.h"
+#include "concurrent_union_find.h"
+#include "csr_graph.h"
 #include "graph.h"
 #include "kruskal.h"
+#include "undirected_graph.h"
 
 class Edge {
 public:
@@ -226,35 +235,36 @@ void test10() {
   }
 }
 
-// read from file
-#include <fstream>
-
-void solve_from_file(const char* filename) {
-  std::ifstream in(filename); // closed automatically
-  if (in.fail()) {
-    throw "Cannot open input file";
+// MST engines under test
+struct Kruskal {
+  template<typename GraphType>
+  std::vector<Edge> operator()(const GraphType& g) const {
+    return kruskal(g);
   }
+};
 
-  // read problem
-  int V, M;
-  in >> V >> M;
-
-  Graph<Vertex, Edge> g;
-
-  // insert vertices
-  for (int i = 0; i < V; ++i) {
-    g.InsertVertex(Vertex(i));
+struct KruskalUnionFind {
+  template<typename GraphType>
+  std::vector<Edge> operator()(const GraphType& g) const {
+    return kruskal<UnionFind>(g);
   }
+};
 
-  for (int e = 0; e < M; ++e) {
-    size_t v1, v2, w;
-    in >> v1 >> v2 >> w;
-    g.InsertEdge(Edge(v1, v2, w));
-    g.InsertEdge(Edge(v2, v1, w));
+struct FilterKruskal {
+  template<typename GraphType>
+  std::vector<Edge> operator()(const GraphType& g) const {
+    return filter_kruskal(g);
   }
+};
 
-  std::vector<Edge> mst = kruskal(g);
+struct Boruvka {
+  template<typename GraphType>
+  std::vector<Edge> operator()(const GraphType& g) const {
+    return boruvka(g, 4);
+  }
+};
 
+void print_total_length(std::vector<Edge> mst) {
   std::sort(mst.begin(), mst.end());
 
   std::vector<Edge>::const_iterator it_edges = mst.begin(),
@@ -268,6 +278,55 @@ void solve_from_file(const char* filename) {
   std::cout << "  total length = " << length << std::endl;
 }
 
+// read from file
+#include <fstream>
+#include <type_traits>
+#include "edge_list_reader.h"
+
+// graphs that store an undirected edge once are given each edge once, the
+// others get both directions
+template<typename GraphType>
+inline constexpr bool kStoresEdgesOnce =
+  std::is_same_v<GraphType, UndirectedGraph<Vertex, Edge>>;
+
+// byte ranges of the file are parsed in parallel once there are at least
+// two of them; smaller files (every sample graph) start no threads
+EdgeList<Edge> read_problem(const char* filename, const bool both_directions) {
+  const MappedFile file{filename};
+  const char* const end = file.data() + file.size();
+  if (file.size() < 2 * kParseChunkBytes) {
+    return parse_edge_list<Edge>(file.data(), end, both_directions);
+  }
+
+  ThreadPool pool{};
+  return parse_edge_list<Edge>(file.data(), end, both_directions, pool);
+}
+
+template<typename GraphType = Graph<Vertex, Edge>, typename Solver = Kruskal>
+void solve_from_file(const char* filename) {
+  // read problem
+  EdgeList<Edge> problem = read_problem(filename, !kStoresEdgesOnce<GraphType>);
+
+  GraphType g;
+
+  // insert vertices
+  for (size_t i = 0; i < problem.vertex_count; ++i) {
+    g.InsertVertex(Vertex(i));
+  }
+
+  // Graph::BuildFromEdgeArray only fills the edge list, InsertEdge also
+  // keeps GetOutEdges() populated as the original loop did
+  if constexpr (std::is_same_v<GraphType, Graph<Vertex, Edge>>) {
+    for (const Edge& e: problem.edges) {
+      g.InsertEdge(e);
+    }
+  } else {
+    g.BuildFromEdgeArray(problem.edges.data(), problem.edges.size());
+  }
+
+  print_total_length(Solver{}(g));
+}
+
 void test11() { solve_from_file("g5"); }
 
 void test12() { solve_from_file("g5_2"); }
@@ -284,7 +343,8 @@ void test16() { solve_from_file("g1000"); }
 #include <numeric>   // iota
 #include <random>    // RNG
 
-void random_graph(unsigned int N, Graph<Vertex, Edge>& g, unsigned int K) {
+template<typename GraphType>
+void random_graph(unsigned int N, GraphType& g, unsigned int K) {
   for (unsigned int i = 0; i < N; ++i) {
     g.InsertVertex(Vertex(i));
   }
@@ -293,7 +353,9 @@ void random_graph(unsigned int N, Graph<Vertex, Edge>& g, unsigned int K) {
   // so that there is an MST of weight N-1
   for (unsigned int i = 0; i < N - 1; ++i) {
     g.InsertEdge(Edge(i, i + 1, 1));
-    g.InsertEdge(Edge(i + 1, i, 1));
+    if constexpr (!kStoresEdgesOnce<GraphType>) {
+      g.InsertEdge(Edge(i + 1, i, 1));
+    }
     // std::cout << i << " - " << i+1 << std::endl;
   }
 
@@ -315,31 +377,1161 @@ void random_graph(unsigned int N, Graph<Vertex, Edge>& g, unsigned int K) {
     first2K.resize(2 * K);
 
     for (unsigned int i = 0; i < 2 * K; i += 2) {
-      // this edges will not be used in MST
-      g.InsertEdge(Edge(first2K[i], first2K[i + 1], weight(gen)));
-      g.InsertEdge(Edge(first2K[i + 1], first2K[i], weight(gen)));
+      // this edges will not be used in MST; both weights are drawn for
+      // every graph type so that all of them see the same random stream
+      const int forward = weight(gen);
+      const int backward = weight(gen);
+      g.InsertEdge(Edge(first2K[i], first2K[i + 1], forward));
+      if constexpr (!kStoresEdgesOnce<GraphType>) {
+        g.InsertEdge(Edge(first2K[i + 1], first2K[i], backward));
+      }
     }
   }
 }
 
-void test17() {
-  Graph<Vertex, Edge> g;
+template<typename GraphType, typename Solver = Kruskal>
+void solve_random_graph() {
+  GraphType g;
   random_graph(1000000, g, 10);
-  std::vector<Edge> mst = kruskal(g);
+  if constexpr (!std::is_same_v<GraphType, Graph<Vertex, Edge>>) {
+    g.Finalize();
+  }
+  print_total_length(Solver{}(g));
+}
 
-  std::sort(mst.begin(), mst.end());
+void test17() { solve_random_graph<Graph<Vertex, Edge>>(); }
+
+// CSR backend, same inputs as test16 and test17
+void test18() { solve_from_file<CsrGraph<Vertex, Edge>>("g1000"); }
+
+void test19() { solve_random_graph<CsrGraph<Vertex, Edge>>(); }
+
+// radix sort: negative floats, equal keys keep input order
+void test20() {
+  const float values[] = {3.5f, -1.0f, 0.0f, 2.0f, -7.25f, 2.0f, 1e9f, -1e-3f};
+  std::vector<KeyedIndex<RadixKey<float>>> order;
+  for (size_t i = 0; i < sizeof(values) / sizeof(*values); ++i) {
+    order.push_back({to_radix_key(values[i]), i});
+  }
+  radix_sort(order);
+  for (const KeyedIndex<RadixKey<float>>& item: order) {
+    std::cout << values[item.index] << " (" << item.index << ")" << std::endl;
+  }
+
+  // small integer range, sorted in a single pass
+  const int weights[] = {10, 2, 7, 2, 1, 10, -3};
+  std::vector<KeyedIndex<RadixKey<int>>> by_weight;
+  for (size_t i = 0; i < sizeof(weights) / sizeof(*weights); ++i) {
+    by_weight.push_back({to_radix_key(weights[i]), i});
+  }
+  radix_sort(by_weight);
+  for (const KeyedIndex<RadixKey<int>>& item: by_weight) {
+    std::cout << weights[item.index] << " (" << item.index << ")" << std::endl;
+  }
+}
+
+// filter-kruskal, same inputs as test16 and test17
+void test21() { solve_from_file<Graph<Vertex, Edge>, FilterKruskal>("g1000"); }
+
+void test22() { solve_random_graph<CsrGraph<Vertex, Edge>, FilterKruskal>(); }
+
+// parallel boruvka, same input as test16
+void test23() { solve_from_file<CsrGraph<Vertex, Edge>, Boruvka>("g1000"); }
+
+// both directions of every edge of a "V M / u v w" file
+std::vector<Edge> load_edges(const char* filename) {
+  std::ifstream in(filename);
+  int V, M;
+  in >> V >> M;
+
+  std::vector<Edge> edges;
+  for (int e = 0; e < M; ++e) {
+    size_t v1, v2, w;
+    in >> v1 >> v2 >> w;
+    edges.emplace_back(v1, v2, w);
+    edges.emplace_back(v2, v1, w);
+  }
+  return edges;
+}
+
+bool same_edges(const std::vector<Edge>& a, const std::vector<Edge>& b) {
+  bool same = a.size() == b.size();
+  for (size_t i = 0; same && i < a.size(); ++i) {
+    same = a[i].ID1() == b[i].ID1() && a[i].ID2() == b[i].ID2();
+  }
+  return same;
+}
+
+const char* mst_files[] = {"g5", "g5_2", "g5_3", "g10", "g500", "g1000"};
+
+// boruvka must return kruskal's exact edge vector for any thread count
+void test24() {
+  for (const char* filename: mst_files) {
+    std::vector<Edge> edges = load_edges(filename);
+    CsrGraph<Vertex, Edge> g;
+    g.BuildFromEdgeArray(edges.data(), edges.size());
+
+    const std::vector<Edge> expected = kruskal(g);
+    for (size_t threads = 1; threads <= 8; threads *= 2) {
+      std::cout << filename << " threads " << threads
+                << (same_edges(boruvka(g, threads), expected) ? " identical"
+                                                              : " DIFFERENT")
+                << std::endl;
+    }
+  }
+
+  // a throwing task: every other task still runs, Run rethrows once the
+  // job is over and the pool stays usable
+  ThreadPool pool{4};
+  std::atomic<size_t> finished{0};
+  try {
+    pool.Run(64, [&](const size_t i) {
+      if (i % 8 == 3) {
+        throw std::runtime_error{"task failed"};
+      }
+      ++finished;
+    });
+  } catch (const std::exception& error) {
+    std::cout << error.what() << ", " << finished.load() << " tasks finished";
+  }
+  finished = 0;
+  pool.Run(64, [&](size_t) { ++finished; });
+  std::cout << ", then " << finished.load() << std::endl;
+}
+
+// parallel sort stage, list (Graph) and contiguous (CsrGraph) edges
+void test25() {
+  for (const char* filename: mst_files) {
+    std::vector<Edge> edges = load_edges(filename);
+    Graph<Vertex, Edge> list_graph;
+    list_graph.BuildFromEdgeArray(edges.data(), edges.size());
+    CsrGraph<Vertex, Edge> csr_graph;
+    csr_graph.BuildFromEdgeArray(edges.data(), edges.size());
+
+    const std::vector<Edge> expected = kruskal(list_graph);
+    for (size_t threads = 1; threads <= 8; threads *= 2) {
+      ThreadPool pool{threads};
+      const bool same = same_edges(kruskal(list_graph, pool), expected)
+                     && same_edges(kruskal(csr_graph, pool), expected);
+      std::cout << filename << " threads " << threads
+                << (same ? " identical" : " DIFFERENT") << std::endl;
+    }
+  }
+}
+
+// UnionFind must partition exactly like DisjointSets for the same joins
+template<typename Sets>
+bool same_partition(DisjointSets& ds, Sets& other, int size) {
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j) {
+      const bool together = ds.GetRepresentative(i) == ds.GetRepresentative(j);
+      if (together
+          != (other.GetRepresentative(i) == other.GetRepresentative(j))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void test26() {
+  const int size = 300;
+  DisjointSets ds(size);
+  UnionFind uf(size);
+  for (int i = 0; i < size; ++i) {
+    ds.Make();
+    uf.Make();
+  }
+
+  // everything into 0 (test6/test7), then a long chain, then random pairs
+  for (int i = 1; i < 50; ++i) {
+    ds.Join(i, 0);
+    uf.Join(i, 0);
+  }
+  for (int i = 100; i < 199; ++i) {
+    ds.Join(i + 1, i);
+    uf.Join(i + 1, i);
+  }
+  std::cout << "chains "
+            << (same_partition(ds, uf, size) ? "identical" : "DIFFERENT")
+            << std::endl;
+
+  std::mt19937 gen(280);
+  std::uniform_int_distribution<int> id(0, size - 1);
+  for (int i = 0; i < 150; ++i) {
+    const int a = id(gen), b = id(gen);
+    ds.Join(a, b);
+    uf.Join(a, b);
+  }
+  std::cout << "random "
+            << (same_partition(ds, uf, size) ? "identical" : "DIFFERENT")
+            << std::endl;
+}
+
+// kruskal over the flat union-find backend, same input as test17
+void test27() {
+  solve_random_graph<CsrGraph<Vertex, Edge>, KruskalUnionFind>();
+}
+
+// concurrent union-find hammered from many threads must end with the same
+// partition as a sequential run of the same joins
+#include <thread>
+
+void test28() {
+  const size_t size = 200000;
+  const size_t threads = 8;
+  const size_t joins = 150000;
+
+  std::mt19937 gen(280);
+  std::uniform_int_distribution<size_t> id(0, size - 1);
+
+  for (int round = 0; round < 5; ++round) {
+    std::vector<std::pair<size_t, size_t>> pairs(joins);
+    for (std::pair<size_t, size_t>& pair: pairs) {
+      pair = {id(gen), id(gen)};
+    }
+
+    UnionFind expected(size);
+    ConcurrentUnionFind shared(size);
+    for (size_t i = 0; i < size; ++i) {
+      expected.Make();
+      shared.Make();
+    }
+    for (const std::pair<size_t, size_t>& pair: pairs) {
+      expected.Join(pair.first, pair.second);
+    }
+
+    // interleaved slices so every thread touches every region, with
+    // connectivity queries mixed in
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        for (size_t i = t; i < joins; i += threads) {
+          shared.Join(pairs[i].first, pairs[i].second);
+          const size_t other = pairs[joins - 1 - i].first;
+          std::ignore = shared.SameSet(pairs[i].second, other);
+        }
+      });
+    }
+    for (std::thread& worker: workers) {
+      worker.join();
+    }
+
+    // representatives must map one-to-one between the two runs
+    std::vector<size_t> forward(size, size), backward(size, size);
+    bool same = true;
+    for (size_t i = 0; same && i < size; ++i) {
+      const size_t a = expected.GetRepresentative(i);
+      const size_t b = shared.GetRepresentative(i);
+      if (forward[a] == size && backward[b] == size) {
+        forward[a] = b;
+        backward[b] = a;
+      }
+      same = forward[a] == b && backward[b] == a;
+    }
+    std::cout << "round " << round << (same ? " identical" : " DIFFERENT")
+              << std::endl;
+  }
+
+  // and it plugs into kruskal like any other backend
+  std::vector<Edge> edges = load_edges("g1000");
+  CsrGraph<Vertex, Edge> g;
+  g.BuildFromEdgeArray(edges.data(), edges.size());
+  print_total_length(kruskal<ConcurrentUnionFind>(g));
+}
+
+// hand-rolled scanner: integer, fractional, signed and exponent weights
+void test29() {
+  const char text[] = "4 6\n0 1 3\n1 2 2.5\n2 3\t-0.125\r\n"
+                      "3 0 1e3\n0 2 .75\n1 3 +12.5E-1";
+  EdgeList<Edge> list =
+    parse_edge_list<Edge>(text, text + sizeof(text) - 1, false);
+  std::cout << "V = " << list.vertex_count << std::endl;
+  for (const Edge& e: list.edges) {
+    std::cout << e << " " << e.Weight() << std::endl;
+  }
+
+  // a bogus edge count must not allocate, an ID past size_t must not wrap
+  for (const char* bad: {"2 1\n0 x 1\n",
+                         "2 18446744073709551615\n0 1 1\n",
+                         "2 1\n0 18446744073709551616 1\n"}) {
+    try {
+      std::ignore = parse_edge_list<Edge>(bad, bad + std::strlen(bad));
+    } catch (const char* error) {
+      std::cout << error << std::endl;
+    }
+  }
+}
+
+// binary format round trip: text and dot inputs, kruskal reads the mapping
+#include "dot_reader.h"
+
+template<typename Index, typename Weight>
+void solve_binary(const char* binary) {
+  const BinaryGraph<Index, Weight> g{binary};
+  const std::vector<typename BinaryGraph<Index, Weight>::Edge> mst = kruskal(g);
 
-  std::vector<Edge>::const_iterator it_edges = mst.begin(),
-                                    it_edges_end = mst.end();
   float length = 0.0f;
+  for (const auto& edge: mst) {
+    length += static_cast<float>(edge.Weight());
+  }
+  std::cout << "V = " << g.Size() << " M = " << g.GetEdges().size()
+            << " total length = " << length << std::endl;
+}
 
-  for (; it_edges != it_edges_end; ++it_edges) {
-    // std::cout << *it_edges << " ";
-    length += it_edges->Weight();
+void test30() {
+  const char* binary = "test30.bin";
+
+  EdgeList<Edge> text = read_edge_list<Edge>("g1000", false);
+  write_binary_graph<uint32_t, float>(binary, text.vertex_count, text.edges);
+  solve_binary<uint32_t, float>(binary);
+
+  EdgeList<Edge> dot = read_dot_edges<Edge>("g10.dot");
+  write_binary_graph<uint64_t, double>(binary, dot.vertex_count, dot.edges);
+  solve_binary<uint64_t, double>(binary);
+
+  try {
+    solve_binary<uint32_t, float>(binary);
+  } catch (const char* error) {
+    std::cout << error << std::endl;
   }
-  std::cout << "  total length = " << length << std::endl;
+
+  // corrupt files: an edge count that wraps the record size, an endpoint
+  // past V
+  const uint64_t counts[] = { dot.edges.size() + (uint64_t{1} << 62), 18 };
+  const uint32_t endpoints[] = { 0, 10 };
+  for (size_t c = 0; c < 2; ++c) {
+    write_binary_graph<uint32_t, float>(binary, dot.vertex_count, dot.edges);
+    {
+      const auto mode = std::ios::in | std::ios::out | std::ios::binary;
+      std::fstream file{binary, mode};
+      file.seekp(offsetof(BinaryGraphHeader, edge_count));
+      file.write(reinterpret_cast<const char*>(&counts[c]), sizeof(uint64_t));
+      file.seekp(sizeof(BinaryGraphHeader));
+      file.write(reinterpret_cast<const char*>(&endpoints[c]), 4);
+    }
+    try {
+      solve_binary<uint32_t, float>(binary);
+    } catch (const char* error) {
+      std::cout << error << std::endl;
+    }
+  }
+
+  std::remove(binary);
 }
 
+// streaming MST under a budget of a few hundred bytes per vertex: many runs
+// merged two at a time over several levels and many forest merges, still
+// kruskal's exact edge vector
+#include "external_mst.h"
+
+void test31() {
+  const ExternalMstOptions::Mode modes[] = {
+    ExternalMstOptions::Mode::SortSpill, ExternalMstOptions::Mode::ForestMerge
+  };
+
+  for (const char* filename: mst_files) {
+    std::vector<Edge> edges = load_edges(filename);
+    CsrGraph<Vertex, Edge> g;
+    g.BuildFromEdgeArray(edges.data(), edges.size());
+    const std::vector<Edge> expected = kruskal(g);
+
+    for (const ExternalMstOptions::Mode mode: modes) {
+      EdgeListSource<Edge> source{filename};
+      ExternalMstOptions options{};
+      options.memory_budget = source.VertexCount() * 256;
+      options.max_merge_runs = 2;
+      options.mode = mode;
+
+      const std::vector<Edge> mst =
+        external_mst(source, source.VertexCount(), options);
+      std::cout << filename
+                << (mode == ExternalMstOptions::Mode::SortSpill ? " spill"
+                                                                : " merge")
+                << (same_edges(mst, expected) ? " identical" : " DIFFERENT")
+                << std::endl;
+    }
+  }
+
+  try {
+    EdgeListSource<Edge> source{"g1000"};
+    ExternalMstOptions options{};
+    options.memory_budget = 1024;
+    (void)external_mst(source, source.VertexCount(), options);
+  } catch (const char* error) {
+    std::cout << error << std::endl;
+  }
+
+  // an endpoint past the header's V is rejected, not looked up
+  const char* bad = "test31.txt";
+  std::ofstream{bad} << "2 2\n0 500000 1\n0 1 2\n";
+  for (const ExternalMstOptions::Mode mode: modes) {
+    try {
+      EdgeListSource<Edge> source{bad};
+      ExternalMstOptions options{};
+      options.mode = mode;
+      (void)external_mst(source, source.VertexCount(), options);
+    } catch (const char* error) {
+      std::cout << error << std::endl;
+    }
+  }
+  std::remove(bad);
+}
+
+// incremental forest after each of 4 batches against kruskal on the prefix
+#include "incremental_mst.h"
+
+void test32() {
+  for (const char* filename: mst_files) {
+    std::vector<Edge> edges = load_edges(filename);
+    const size_t V = read_edge_list<Edge>(filename).vertex_count;
+    IncrementalMst<Edge> forest{V};
+
+    const size_t batch = (edges.size() + 3) / 4;
+    for (size_t first = 0; first < edges.size(); first += batch) {
+      const size_t last = std::min(edges.size(), first + batch);
+      forest.InsertBatch(Span<const Edge>{edges.data() + first, last - first});
+
+      Graph<Vertex, Edge> g;
+      for (size_t v = 0; v < V; ++v) {
+        g.InsertVertex(Vertex(v));
+      }
+      g.BuildFromEdgeArray(edges.data(), last);
+      std::cout << filename << " " << forest.Inserted() << " edges "
+                << forest.EdgeCount() << " in forest"
+                << (same_edges(forest.Forest(), kruskal(g)) ? " identical"
+                                                            : " DIFFERENT")
+                << std::endl;
+    }
+  }
+}
+
+// MstStats: the same output with and without MST_INSTRUMENT, the counters
+// are checked against the MST when they are collected and must stay zero
+// when they are not
+#include <sstream>
+
+template<typename Sets>
+void check_stats(const char* name, const std::vector<Edge>& edges) {
+  CsrGraph<Vertex, Edge> g;
+  g.BuildFromEdgeArray(edges.data(), edges.size());
+
+  mst_stats().Reset();
+  const std::vector<Edge> mst = kruskal<Sets>(g);
+  const MstStats& stats = mst_stats();
+
+  size_t finds = 0;
+  for (const size_t count: stats.find_path_lengths) {
+    finds += count;
+  }
+
+  bool consistent;
+  if constexpr (kMstInstrumented) {
+    consistent = stats.edges_accepted == mst.size()
+              && stats.edges_examined == stats.early_exit_index + 1
+              && stats.edges_examined <= edges.size()
+              && stats.nodes_relabelled >= mst.size()
+              && finds >= 2 * stats.edges_examined;
+  } else {
+    consistent = stats.edges_examined == 0 && stats.edges_accepted == 0
+              && stats.nodes_relabelled == 0 && finds == 0
+              && stats.early_exit_index == MstStats::kNoEarlyExit;
+  }
+
+  std::ostringstream json;
+  write_json(json, stats);
+  consistent = consistent && json.str().front() == '{'
+            && json.str().back() == '}';
+
+  std::cout << name << (consistent ? " consistent" : " INCONSISTENT")
+            << std::endl;
+}
+
+// filter_kruskal exits at kruskal's position, having tested at least as
+// many edges as it accepted
+void check_filter_stats(const std::vector<Edge>& edges) {
+  CsrGraph<Vertex, Edge> g;
+  g.BuildFromEdgeArray(edges.data(), edges.size());
+
+  mst_stats().Reset();
+  (void)kruskal(g);
+  const size_t early_exit_index = mst_stats().early_exit_index;
+
+  mst_stats().Reset();
+  const std::vector<Edge> mst = filter_kruskal(g);
+  const MstStats& stats = mst_stats();
+
+  bool consistent;
+  if constexpr (kMstInstrumented) {
+    consistent = stats.edges_accepted == mst.size()
+              && stats.edges_examined >= mst.size()
+              && stats.early_exit_index == early_exit_index;
+  } else {
+    consistent = stats.edges_examined == 0
+              && stats.early_exit_index == MstStats::kNoEarlyExit;
+  }
+  std::cout << "filter_kruskal"
+            << (consistent ? " consistent" : " INCONSISTENT") << std::endl;
+}
+
+// counters of pool workers end up with the thread that called Run
+void check_pool_stats() {
+  ThreadPool pool{2};
+  const size_t tasks = 8;
+  const size_t size = 1000;
+
+  mst_stats().Reset();
+  pool.Run(tasks, [&](size_t) {
+    UnionFind set{size};
+    for (size_t i = 0; i < size; ++i) {
+      set.Make();
+    }
+    for (size_t i = 1; i < size; ++i) {
+      set.Join(0, i);
+    }
+  });
+
+  const size_t expected = kMstInstrumented ? tasks * (size - 1) : 0;
+  std::cout << "ThreadPool"
+            << (mst_stats().nodes_relabelled == expected ? " consistent"
+                                                         : " INCONSISTENT")
+            << std::endl;
+}
+
+void test33() {
+  const std::vector<Edge> edges = load_edges("g1000");
+  check_stats<DisjointSets>("DisjointSets", edges);
+  check_stats<UnionFind>("UnionFind", edges);
+  check_filter_stats(edges);
+  check_pool_stats();
+}
+
+// undirected storage: each edge once in GetEdges, both endpoints in
+// GetOutEdges, same MST weight as the doubled CsrGraph
+void test34() {
+  for (const char* filename: {"g5", "g10", "g1000"}) {
+    EdgeList<Edge> once = read_edge_list<Edge>(filename, false);
+    UndirectedGraph<Vertex, Edge> g;
+    g.BuildFromEdgeArray(once.edges.data(), once.edges.size());
+
+    size_t degrees = 0;
+    bool oriented = true;
+    for (size_t v = 0; v < g.Size(); ++v) {
+      for (const Edge& e: g.GetOutEdges(v)) {
+        oriented = oriented && e.ID1() == v;
+        ++degrees;
+      }
+    }
+
+    std::cout << filename << ": " << g.GetEdges().size() << " edges, "
+              << degrees << " incidences"
+              << (oriented ? ", oriented" : ", NOT oriented") << std::endl;
+    print_total_length(kruskal(g));
+    solve_from_file<CsrGraph<Vertex, Edge>>(filename);
+  }
+
+  UndirectedGraph<Vertex, Edge> small;
+  small.InsertEdge(Edge(0, 2, 1));
+  small.InsertEdge(Edge(2, 1, 2));
+  small.InsertEdge(Edge(1, 1, 3));
+  small.Finalize();
+  std::cout << small;
+}
+
+// kruskal_with policies: every sort path and index width gives kruskal's
+// edges, a custom key changes what is minimised
+struct CompactPolicy {
+  using Sets = BasicUnionFind<uint32_t>;
+  using Index = uint32_t;
+  static float Key(const Edge& edge) { return edge.Weight(); }
+};
+
+// 8-byte keys: radix sort of (key, index), not the compact records
+struct WideKeyPolicy : KruskalPolicy<Edge, UnionFind, uint32_t> {
+  static double Key(const Edge& edge) { return edge.Weight(); }
+};
+
+// the sample weights are small integers: counting sort
+struct SmallIntegerPolicy : KruskalPolicy<Edge, UnionFind, uint32_t> {
+  static uint16_t Key(const Edge& edge) {
+    return static_cast<uint16_t>(edge.Weight());
+  }
+};
+
+// not arithmetic: comparison sort
+struct PairKeyPolicy : KruskalPolicy<Edge> {
+  static std::pair<float, int> Key(const Edge& edge) {
+    return {edge.Weight(), 0};
+  }
+};
+
+struct MaximumPolicy : KruskalPolicy<Edge, UnionFind> {
+  static float Key(const Edge& edge) { return -edge.Weight(); }
+};
+
+struct TinyIndexPolicy : KruskalPolicy<Edge, UnionFind, uint8_t> {};
+
+void test35() {
+  for (const char* filename: mst_files) {
+    const std::vector<Edge> edges = load_edges(filename);
+    CsrGraph<Vertex, Edge> g;
+    g.BuildFromEdgeArray(edges.data(), edges.size());
+
+    const std::vector<Edge> expected = filter_kruskal(g);
+    const bool same = same_edges(kruskal_with<CompactPolicy>(g), expected)
+                   && same_edges(kruskal_with<WideKeyPolicy>(g), expected)
+                   && same_edges(kruskal_with<SmallIntegerPolicy>(g), expected)
+                   && same_edges(kruskal_with<PairKeyPolicy>(g), expected);
+    std::cout << filename << (same ? " identical" : " DIFFERENT") << std::endl;
+
+    std::cout << "  maximum spanning tree:";
+    print_total_length(kruskal_with<MaximumPolicy>(g));
+  }
+
+  try {
+    CsrGraph<Vertex, Edge> g;
+    g.InsertVertex(Vertex(300));
+    g.Finalize();
+    (void)kruskal_with<TinyIndexPolicy>(g);
+  } catch (const char* error) {
+    std::cout << error << std::endl;
+  }
+}
+
+// batched DisjointSets queries: same answers as one GetRepresentative at a
+// time, component labels and sizes agree with the representatives
+void test36() {
+  const size_t n = 10000;
+  DisjointSets ds(n);
+  for (size_t i = 0; i < n; ++i) {
+    ds.Make();
+  }
+
+  std::mt19937 gen(36);
+  std::uniform_int_distribution<size_t> id(0, n - 1);
+  for (size_t i = 0; i < 9 * n / 10; ++i) {
+    ds.Join(id(gen), id(gen));
+  }
+
+  std::vector<size_t> ids(n);
+  std::vector<std::pair<size_t, size_t>> pairs(n);
+  for (size_t i = 0; i < n; ++i) {
+    ids[i] = id(gen);
+    pairs[i] = {id(gen), i % 2 ? id(gen) : ds.GetRepresentative(ids[i])};
+  }
+
+  std::vector<size_t> representatives(n);
+  ds.GetRepresentatives(ids, representatives);
+  std::vector<uint8_t> connected(n);
+  ds.Connected(pairs, connected);
+  const ComponentLabels components = ds.GetComponents();
+
+  bool consistent = components.labels.size() == n;
+  size_t total = 0;
+  for (const size_t size: components.sizes) {
+    total += size;
+  }
+  consistent = consistent && total == n;
+  for (size_t i = 0; i < n && consistent; ++i) {
+    const auto [u, v] = pairs[i];
+    consistent = representatives[i] == ds.GetRepresentative(ids[i])
+              && connected[i]
+                   == (ds.GetRepresentative(u) == ds.GetRepresentative(v))
+              && connected[i]
+                   == (components.labels[u] == components.labels[v]);
+  }
+  std::cout << (consistent ? "consistent, " : "INCONSISTENT, ")
+            << components.sizes.size() << " components" << std::endl;
+
+  DisjointSets small(6);
+  for (size_t i = 0; i < 6; ++i) {
+    small.Make();
+  }
+  small.Join(4, 1);
+  small.Join(5, 3);
+  small.Join(3, 1);
+  const ComponentLabels labels = small.GetComponents();
+  for (const size_t label: labels.labels) {
+    std::cout << label << " ";
+  }
+  std::cout << "| ";
+  for (const size_t size: labels.sizes) {
+    std::cout << size << " ";
+  }
+  std::cout << std::endl;
+}
+
+// Prim: heap (binary and 4-ary) and dense variants give kruskal's exact
+// edge vector on list and contiguous graphs, forests included
+#include <cmath> // floor
+#include "graph_generators.h"
+#include "prim.h"
+
+struct Prim {
+  template<typename GraphType>
+  std::vector<Edge> operator()(const GraphType& g) const {
+    return prim(g);
+  }
+};
+
+template<typename GraphType>
+bool prim_matches_kruskal(const GraphType& g) {
+  const std::vector<Edge> expected = kruskal(g);
+  return same_edges(prim(g), expected) && same_edges(prim<4>(g), expected)
+      && same_edges(dense_prim(g), expected)
+      && same_edges(minimum_spanning_tree(g), expected);
+}
+
+void test37() {
+  for (const char* filename: mst_files) {
+    std::vector<Edge> edges = load_edges(filename);
+    Graph<Vertex, Edge> list_graph;
+    list_graph.BuildFromEdgeArray(edges.data(), edges.size());
+    CsrGraph<Vertex, Edge> csr_graph;
+    csr_graph.BuildFromEdgeArray(edges.data(), edges.size());
+
+    const bool same =
+      prim_matches_kruskal(list_graph) && prim_matches_kruskal(csr_graph);
+    std::cout << filename << (same ? " identical" : " DIFFERENT") << std::endl;
+  }
+
+  // two components and an isolated vertex
+  Graph<Vertex, Edge> forest;
+  for (size_t i = 0; i < 7; ++i) {
+    forest.InsertVertex(Vertex(i));
+  }
+  for (const Edge& e: {Edge(0, 1, 2), Edge(1, 2, 2), Edge(0, 2, 1),
+                       Edge(4, 5, 3), Edge(5, 6, 1), Edge(4, 6, 3)}) {
+    forest.InsertEdge(e);
+    forest.InsertEdge(Edge(e.ID2(), e.ID1(), e.Weight()));
+  }
+  std::cout << "forest"
+            << (prim_matches_kruskal(forest) ? " identical" : " DIFFERENT")
+            << std::endl;
+  print_total_length(prim(forest));
+
+  // dense: every pair, few distinct weights so ties decide the tree
+  EdgeList<Edge> dense = complete<Edge>(200, 37);
+  for (Edge& e: dense.edges) {
+    e = Edge(e.ID1(), e.ID2(), std::floor(e.Weight() * 8));
+  }
+  UndirectedGraph<Vertex, Edge> complete_graph;
+  complete_graph.BuildFromEdgeArray(dense.edges.data(), dense.edges.size());
+  std::cout << "complete"
+            << (prim_matches_kruskal(complete_graph) ? " identical"
+                                                     : " DIFFERENT")
+            << std::endl;
+
+  solve_from_file<Graph<Vertex, Edge>, Prim>("g1000");
+}
+
+// minimum spanning forest: several sample graphs side by side plus isolated
+// vertices, every tree equals kruskal's edges within that component; empty
+// graphs give empty results from every engine
+#include "spanning_forest.h"
+
+void test38() {
+  std::vector<Edge> regions{};
+  size_t offset = 0;
+  for (const char* filename: {"g10", "g5_2", "g1000", "g5"}) {
+    std::ifstream in(filename);
+    size_t V = 0;
+    in >> V;
+    for (const Edge& e: load_edges(filename)) {
+      regions.emplace_back(e.ID1() + offset, e.ID2() + offset, e.Weight());
+    }
+    offset += V + 1; // the vertex after each region stays isolated
+  }
+  CsrGraph<Vertex, Edge> g;
+  for (size_t i = 0; i < offset; ++i) {
+    g.InsertVertex(Vertex(i));
+  }
+  g.BuildFromEdgeArray(regions.data(), regions.size());
+
+  const std::vector<Edge> expected = kruskal(g);
+  for (size_t threads = 1; threads <= 4; threads *= 2) {
+    const SpanningForest<Edge> forest = minimum_spanning_forest(g, threads);
+
+    bool same = forest.edges.size() == expected.size();
+    for (size_t c = 0; c < forest.Components(); ++c) {
+      std::vector<Edge> tree{}, kruskal_tree{};
+      for (const Edge& e: forest.Tree(c)) {
+        tree.push_back(e);
+      }
+      for (const Edge& e: expected) {
+        if (forest.component[e.ID1()] == c) {
+          kruskal_tree.push_back(e);
+        }
+      }
+      same = same && same_edges(tree, kruskal_tree);
+    }
+
+    std::cout << "threads " << threads << ": " << forest.Components()
+              << " components,";
+    for (size_t c = 0; c < forest.Components(); ++c) {
+      std::cout << " " << forest.Tree(c).size();
+    }
+    std::cout << (same ? " identical" : " DIFFERENT") << std::endl;
+  }
+
+  const CsrGraph<Vertex, Edge> empty{};
+  ThreadPool pool{2};
+  std::cout << "empty: " << kruskal(empty).size() << " "
+            << kruskal(empty, pool).size() << " "
+            << filter_kruskal(empty).size() << " "
+            << minimum_spanning_forest(empty, pool).Components() << std::endl;
+}
+
+// sparse 64-bit IDs: renumbered, solved and mapped back, the tree is the
+// dense one with every ID mapped the same way
+#include "id_map.h"
+
+void test39() {
+  const auto sparse = [](const size_t id) -> size_t {
+    return id * 0x9e3779b97f4a7c15ULL + 0x5bd1e995;
+  };
+
+  for (const char* filename: mst_files) {
+    const std::vector<Edge> edges = load_edges(filename);
+    std::vector<Edge> remapped{};
+    for (const Edge& e: edges) {
+      remapped.emplace_back(sparse(e.ID1()), sparse(e.ID2()), e.Weight());
+    }
+
+    CsrGraph<Vertex, Edge> dense;
+    dense.BuildFromEdgeArray(edges.data(), edges.size());
+    std::vector<Edge> expected{};
+    for (const Edge& e: kruskal(dense)) {
+      expected.emplace_back(sparse(e.ID1()), sparse(e.ID2()), e.Weight());
+    }
+
+    const CompactGraph<Edge> compact =
+      compact_ids(Span<const Edge>{remapped});
+    const std::vector<Edge> mst = solve_sparse(
+      Span<const Edge>{remapped},
+      [](const CompactGraph<Edge>& g) { return kruskal(g); }
+    );
+    std::cout << filename << ": " << compact.Size() << " vertices"
+              << (same_edges(mst, expected) ? ", identical" : ", DIFFERENT")
+              << std::endl;
+  }
+
+  DenseIdMap ids{};
+  for (const uint64_t id: {uint64_t{0}, ~uint64_t{0}, uint64_t{42}}) {
+    std::cout << ids.Insert(id) << " ";
+  }
+  std::cout << ids.Insert(42) << " " << ids.Find(~uint64_t{0}) << " "
+            << (ids.Find(7) == DenseIdMap::kNotFound ? "not found" : "found")
+            << std::endl;
+}
+
+// parallel parser: the sequential parser's edges for any thread count and
+// range size, CRLF, a missing final newline and any line layout included;
+// too few numbers is an error
+bool same_edge_list(const EdgeList<Edge>& a, const EdgeList<Edge>& b) {
+  bool same = a.vertex_count == b.vertex_count && same_edges(a.edges, b.edges);
+  for (size_t i = 0; same && i < a.edges.size(); ++i) {
+    same = a.edges[i].Weight() == b.edges[i].Weight();
+  }
+  return same;
+}
+
+void test40() {
+  for (const char* filename: mst_files) {
+    const EdgeList<Edge> expected = read_edge_list<Edge>(filename);
+    bool same = true;
+    for (size_t threads = 1; threads <= 8; threads *= 2) {
+      ThreadPool pool{threads};
+      for (const size_t chunk_bytes: {size_t{7}, size_t{100}, size_t{4096}}) {
+        same = same
+            && same_edge_list(
+                 read_edge_list<Edge>(filename, true, pool, chunk_bytes),
+                 expected
+            )
+            && same_edge_list(
+                 read_edge_list<Edge>(filename, false, pool, chunk_bytes),
+                 read_edge_list<Edge>(filename, false)
+            );
+      }
+    }
+    std::cout << filename << (same ? " identical" : " DIFFERENT") << std::endl;
+  }
+
+  ThreadPool pool{3};
+  const std::string text = "4 3\r\n0 1 2.5\r\n1 2 -1\r\n\r\n2 3 1e1";
+  const EdgeList<Edge> crlf = parse_edge_list<Edge>(
+    text.data(), text.data() + text.size(), false, pool, 4
+  );
+  for (const Edge& e: crlf.edges) {
+    std::cout << e << " " << e.Weight() << std::endl;
+  }
+
+  const std::string short_text = "3 3\n0 1 1\n1 2 1\n";
+  try {
+    (void)parse_edge_list<Edge>(
+      short_text.data(), short_text.data() + short_text.size(), true, pool, 4
+    );
+  } catch (const char* error) {
+    std::cout << error << std::endl;
+  }
+
+  // any whitespace layout: several edges on a line, an edge across lines;
+  // both parsers accept or reject the same texts
+  const std::string layouts[] = {
+    "5 4\n0 1 1.5 1 2 2\n2 3 3 3 4 4\n",
+    "5 4\n0\n1\n1.5\n1 2\n2 2 3 3 3\n4\t4",
+    "5 4 0 1 1.5   1 2 2\n\n 2 3\n3 3 4 4 trailing",
+    "5 4\n0 1 1.5 1 2 2x 2 3 3 3 4 4\n",
+    "5 4\n0 1 1.5 1 2 2 2 3 3\n"
+  };
+  for (const std::string& layout: layouts) {
+    const char* const first = layout.data();
+    const char* const last = first + layout.size();
+    std::string expected;
+    try {
+      const EdgeList<Edge> list = parse_edge_list<Edge>(first, last, false);
+      for (size_t i = 0; i < list.edges.size(); ++i) {
+        std::cout << (i ? " " : "") << list.edges[i] << " "
+                  << list.edges[i].Weight();
+      }
+      std::cout << std::endl;
+    } catch (const char* error) {
+      std::cout << error << std::endl;
+      expected = error;
+    }
+
+    bool same = true;
+    for (size_t chunk_bytes = 1; chunk_bytes <= layout.size(); ++chunk_bytes) {
+      try {
+        const EdgeList<Edge> parallel =
+          parse_edge_list<Edge>(first, last, false, pool, chunk_bytes);
+        same = same && expected.empty()
+            && same_edge_list(
+                 parallel, parse_edge_list<Edge>(first, last, false)
+            );
+      } catch (const char* error) {
+        same = same && expected == error;
+      }
+    }
+    std::cout << "  parallel " << (same ? "identical" : "DIFFERENT")
+              << std::endl;
+  }
+}
+
+// single linkage: the clusters left by the first V - k joins of kruskal()'s
+// tree, or by its edges up to the distance threshold
+#include "clustering.h"
+
+std::vector<size_t> prefix_labels(
+  const size_t V,
+  const std::vector<Edge>& mst,
+  const size_t joins
+) {
+  DisjointSets set{V};
+  for (size_t i = 0; i < V; ++i) {
+    set.Make();
+  }
+  for (size_t i = 0; i < joins; ++i) {
+    set.Join(mst[i].ID1(), mst[i].ID2());
+  }
+  return set.GetComponents().labels;
+}
+
+void test41() {
+  for (const char* filename: mst_files) {
+    const std::vector<Edge> edges = load_edges(filename);
+    CsrGraph<Vertex, Edge> g;
+    g.BuildFromEdgeArray(edges.data(), edges.size());
+    const size_t V = g.Size();
+    const std::vector<Edge> mst = kruskal(g);
+
+    bool same = true;
+    for (size_t k = 1; k <= V + 1; k += 1 + V / 8) {
+      const Clustering<Edge> c = single_linkage(g, k);
+      const size_t joins = V > k ? V - k : 0;
+      same = same && c.labels == prefix_labels(V, mst, joins)
+          && c.Clusters() == V - joins && c.merges.size() == joins;
+    }
+    for (const size_t cut: {size_t{0}, mst.size() / 3, mst.size() - 1}) {
+      const float max_distance = mst[cut].Weight();
+      size_t joins = 0;
+      while (joins < mst.size() && mst[joins].Weight() <= max_distance) {
+        ++joins;
+      }
+      const Clustering<Edge> c = single_linkage(g, 1, max_distance);
+      same = same && c.labels == prefix_labels(V, mst, joins);
+    }
+    std::cout << filename << (same ? " identical" : " DIFFERENT") << std::endl;
+  }
+
+  CsrGraph<Vertex, Edge> g;
+  const std::vector<Edge> edges = load_edges("g5");
+  g.BuildFromEdgeArray(edges.data(), edges.size());
+  for (const Clustering<Edge>& c:
+       {single_linkage(g, 2), single_linkage(g, 3, 5.0f), single_linkage(g, 1)}
+  ) {
+    std::cout << c.Clusters() << " clusters:";
+    for (const size_t label: c.labels) {
+      std::cout << " " << label;
+    }
+    std::cout << "  sizes:";
+    for (const size_t size: c.sizes) {
+      std::cout << " " << size;
+    }
+    std::cout << "  merges:";
+    for (const Edge& e: c.merges) {
+      std::cout << " " << e;
+    }
+    std::cout << std::endl;
+  }
+}
+
+// MST certificate: kruskal()'s tree verifies, path maxima and replacements
+// match a brute force on the small graphs, broken candidates are rejected
+#include "mst_verify.h"
+
+// heaviest edge of 'tree' on the path u -> v, by (weight, index in tree)
+size_t tree_path_max(
+  const std::vector<Edge>& tree,
+  const size_t u,
+  const size_t v,
+  const size_t from = MstCertificate::kNone
+) {
+  for (size_t t = 0; t < tree.size(); ++t) {
+    if (t == from || (tree[t].ID1() != u && tree[t].ID2() != u)) {
+      continue;
+    }
+    const size_t next = tree[t].ID1() == u ? tree[t].ID2() : tree[t].ID1();
+    if (next == v) {
+      return t;
+    }
+    const size_t rest = tree_path_max(tree, next, v, t);
+    if (rest != MstCertificate::kNone) {
+      return tree[rest].Weight() < tree[t].Weight()
+                  || (!(tree[t].Weight() < tree[rest].Weight()) && rest < t)
+             ? t
+             : rest;
+    }
+  }
+  return MstCertificate::kNone;
+}
+
+void test42() {
+  for (const char* filename: mst_files) {
+    const std::vector<Edge> loaded = load_edges(filename);
+    CsrGraph<Vertex, Edge> g;
+    g.BuildFromEdgeArray(loaded.data(), loaded.size());
+    const std::vector<Edge> edges(g.GetEdges().begin(), g.GetEdges().end());
+    const std::vector<Edge> mst = kruskal(g);
+    const MstCertificate c = verify_mst(g, Span<const Edge>{mst});
+
+    bool same = c.spanning && c.minimal;
+    for (size_t t = 0; same && t < mst.size(); ++t) {
+      same = c.path_max[c.position[t]] == t;
+    }
+    if (edges.size() < 100) {
+      for (size_t i = 0; same && i < edges.size(); ++i) {
+        same = c.path_max[i]
+            == tree_path_max(mst, edges[i].ID1(), edges[i].ID2());
+      }
+
+      // lightest edge outside the tree reconnecting it without edge t
+      for (size_t t = 0; same && t < mst.size(); ++t) {
+        UnionFind rest{g.Size()};
+        for (size_t v = 0; v < g.Size(); ++v) {
+          rest.Make();
+        }
+        for (size_t other = 0; other < mst.size(); ++other) {
+          if (other != t) {
+            rest.Join(mst[other].ID1(), mst[other].ID2());
+          }
+        }
+        size_t best = MstCertificate::kNone;
+        for (size_t i = 0; i < edges.size(); ++i) {
+          const Edge& e = edges[i];
+          const bool in_tree =
+            std::find_if(mst.begin(), mst.end(), [&](const Edge& m) {
+              return m.Weight() == e.Weight()
+                  && std::min(m.ID1(), m.ID2()) == std::min(e.ID1(), e.ID2())
+                  && std::max(m.ID1(), m.ID2()) == std::max(e.ID1(), e.ID2());
+            }) != mst.end();
+          if (!in_tree
+              && rest.GetRepresentative(edges[i].ID1())
+                   != rest.GetRepresentative(edges[i].ID2())
+              && (best == MstCertificate::kNone
+                  || edges[i].Weight() < edges[best].Weight())) {
+            best = i;
+          }
+        }
+        same = c.replacement[t] == best;
+      }
+    }
+
+    // swapping a tree edge for its replacement keeps a spanning tree
+    std::vector<Edge> swapped = mst;
+    size_t swaps = 0;
+    for (size_t t = 0; t < mst.size(); ++t) {
+      if (c.replacement[t] != MstCertificate::kNone) {
+        swapped[t] = edges[c.replacement[t]];
+        const MstCertificate s = verify_mst(g, Span<const Edge>{swapped});
+        same = same && s.spanning
+            && s.minimal == !(mst[t].Weight() < swapped[t].Weight());
+        swapped[t] = mst[t];
+        if (++swaps == 3) {
+          break;
+        }
+      }
+    }
+
+    std::vector<Edge> missing(mst.begin(), mst.end() - 1);
+    std::vector<Edge> cycle = mst;
+    cycle.push_back(edges[c.replacement[0]]);
+    same = same && !verify_mst(g, Span<const Edge>{missing}).spanning
+        && !verify_mst(g, Span<const Edge>{cycle}).spanning;
+    std::cout << filename << (same ? " verified" : " WRONG") << std::endl;
+  }
+
+  // a forest: two copies of g10 and an isolated vertex
+  std::vector<Edge> regions = load_edges("g10");
+  for (const Edge& e: load_edges("g10")) {
+    regions.emplace_back(e.ID1() + 11, e.ID2() + 11, e.Weight());
+  }
+  CsrGraph<Vertex, Edge> forest;
+  for (size_t v = 0; v < 21; ++v) {
+    forest.InsertVertex(Vertex(v));
+  }
+  forest.BuildFromEdgeArray(regions.data(), regions.size());
+  const std::vector<Edge> trees = kruskal(forest);
+  const MstCertificate f = verify_mst(forest, Span<const Edge>{trees});
+  std::cout << "forest of " << trees.size() << " edges: "
+            << (f.spanning && f.minimal ? "verified" : "WRONG") << std::endl;
+
+  const std::vector<Edge> loaded = load_edges("g5");
+  CsrGraph<Vertex, Edge> g;
+  g.BuildFromEdgeArray(loaded.data(), loaded.size());
+  const std::vector<Edge> edges(g.GetEdges().begin(), g.GetEdges().end());
+  const std::vector<Edge> mst = kruskal(g);
+  const MstCertificate c = verify_mst(g, Span<const Edge>{mst});
+  for (size_t i = 0; i < edges.size(); ++i) {
+    const Edge& heaviest = mst[c.path_max[i]];
+    std::cout << edges[i] << " " << edges[i].Weight() << ": path max "
+              << heaviest << " " << heaviest.Weight() << std::endl;
+  }
+  for (size_t t = 0; t < mst.size(); ++t) {
+    std::cout << mst[t] << " replaced by " << edges[c.replacement[t]]
+              << std::endl;
+  }
+}
+
+// UndirectedGraph, each edge given once, same inputs as test11-test17
+void test43() {
+  for (const char* filename: {"g5", "g5_2", "g5_3", "g10", "g500", "g1000"}) {
+    solve_from_file<UndirectedGraph<Vertex, Edge>>(filename);
+  }
+}
+
+void test44() { solve_random_graph<UndirectedGraph<Vertex, Edge>>(); }
+
 void (*pTests[])(void) = {
   test0,
   test1,
@@ -358,7 +1550,34 @@ void (*pTests[])(void) = {
   test14,
   test15,
   test16,
-  test17
+  test17,
+  test18,
+  test19,
+  test20,
+  test21,
+  test22,
+  test23,
+  test24,
+  test25,
+  test26,
+  test27,
+  test28,
+  test29,
+  test30,
+  test31,
+  test32,
+  test33,
+  test34,
+  test35,
+  test36,
+  test37,
+  test38,
+  test39,
+  test40,
+  test41,
+  test42,
+  test43,
+  test44
 };
 
 int main(int argc, char** argv) {
@@ -0,0 +1,505 @@
+/*!
+  \brief  Memory-mapped reader for the "V M / u v w" edge-list text format
+
+Implements:
+  parse_edge_list( begin, end, both )   parses a character range
+  read_edge_list( filename, both )      mmaps and parses a file
+  parse_edge_list( begin, end, both, pool )
+  read_edge_list( filename, both, pool )
+                                        the same, byte ranges parsed in
+                                        parallel
+  EdgeListSource                        parses a file chunk by chunk
+
+Rationale:
+  no streams and no locale: the file is mapped, numbers are scanned by hand
+  and edges are written straight into an array sized from the header's M,
+  ready for Graph::BuildFromEdgeArray. With 'both_directions' every line
+  produces (u,v,w) followed by (v,u,w), as the driver always inserted them.
+  The parallel overloads cut the body into byte ranges, each moved forward
+  past the number it would split, so they accept the same layouts as the
+  sequential scanner: any whitespace between numbers, several edges on a
+  line or one edge across lines. A first parallel pass counts the numbers
+  of every range, which fixes which edge (every third number) each range
+  starts and where it goes in the array sized from M; the second pass
+  parses the edges starting in every range straight into its slice,
+  reading on past the range's end to finish its last edge. No per-thread
+  buffers are spliced afterwards and the result does not depend on the
+  thread count or range size. A pool of one thread, or a body of one range,
+  takes the sequential path.
+*/
+
+#ifndef EDGE_LIST_READER_H
+#define EDGE_LIST_READER_H
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "mapped_file.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Vertex count from the header plus the parsed edges
+ */
+template<typename Edge>
+struct EdgeList {
+  size_t vertex_count;
+  std::vector<Edge> edges;
+};
+
+namespace detail {
+  /**
+   * @class TextScanner
+   * @brief Forward-only number scanner over [pos, end)
+   */
+  class TextScanner final {
+  public:
+
+    TextScanner(const char* first, const char* last): pos{first}, end{last} {}
+
+    /**
+     * @brief Next unread character
+     */
+    [[nodiscard]] auto Position() const -> const char* { return pos; }
+
+    /**
+     * @brief Whether only whitespace is left
+     */
+    [[nodiscard]] auto AtEnd() -> bool {
+      SkipSpace();
+      return pos == end;
+    }
+
+    /**
+     * @brief Whether the next character ends a number (whitespace or end)
+     */
+    [[nodiscard]] auto AtSpace() const -> bool {
+      return pos == end || static_cast<unsigned char>(*pos) <= ' ';
+    }
+
+    /**
+     * @brief Skips whitespace and the run of other characters after it
+     */
+    auto SkipToken() -> void {
+      SkipSpace();
+      while (!AtSpace()) {
+        ++pos;
+      }
+    }
+
+    /**
+     * @brief Skips spaces, tabs and line breaks
+     */
+    auto SkipSpace() -> void {
+      while (pos != end && static_cast<unsigned char>(*pos) <= ' ') {
+        ++pos;
+      }
+    }
+
+    /**
+     * @brief Reads a decimal unsigned integer, false if there is none or it
+     * does not fit in size_t
+     */
+    [[nodiscard]] auto ReadUnsigned(size_t& value) -> bool {
+      SkipSpace();
+      const char* const start = pos;
+
+      constexpr size_t limit = std::numeric_limits<size_t>::max();
+      size_t result = 0;
+      unsigned digit;
+      while (pos != end && (digit = Digit(*pos)) < 10) {
+        if (result > (limit - digit) / 10) {
+          return false;
+        }
+        result = result * 10 + digit;
+        ++pos;
+      }
+      value = result;
+      return pos != start;
+    }
+
+    /**
+     * @brief Reads a decimal number ([-]digits[.digits][e[-]digits]), false
+     * if there is none
+     */
+    [[nodiscard]] auto ReadNumber(double& value) -> bool {
+      SkipSpace();
+      const char* const start = pos;
+
+      const bool negative = pos != end && *pos == '-';
+      pos += negative || (pos != end && *pos == '+');
+      const char* const number = pos;
+
+      // up to 19 significant digits are exact in 64 bits, the rest only
+      // move the exponent
+      uint64_t mantissa = 0;
+      int exponent = 0;
+      int digits = 0;
+      unsigned digit;
+      while (pos != end && (digit = Digit(*pos)) < 10) {
+        if (digits < 19) {
+          mantissa = mantissa * 10 + digit;
+          digits += mantissa != 0;
+        } else {
+          ++exponent;
+        }
+        ++pos;
+      }
+      if (pos != end && *pos == '.') {
+        ++pos;
+        while (pos != end && (digit = Digit(*pos)) < 10) {
+          if (digits < 19) {
+            mantissa = mantissa * 10 + digit;
+            digits += mantissa != 0;
+            --exponent;
+          }
+          ++pos;
+        }
+      }
+      if (pos == number || (pos == number + 1 && *number == '.')) {
+        pos = start;
+        return false;
+      }
+
+      if (pos != end && (*pos == 'e' || *pos == 'E')) {
+        ++pos;
+        const bool negative_exponent = pos != end && *pos == '-';
+        pos += negative_exponent || (pos != end && *pos == '+');
+        int written = 0;
+        while (pos != end && (digit = Digit(*pos)) < 10) {
+          written = written < 10000 ? written * 10 + static_cast<int>(digit)
+                                    : written;
+          ++pos;
+        }
+        exponent += negative_exponent ? -written : written;
+      }
+
+      double result = static_cast<double>(mantissa);
+      if (exponent != 0 && mantissa != 0) {
+        result = Scale(result, exponent);
+      }
+      value = negative ? -result : result;
+      return true;
+    }
+
+  private:
+
+    [[nodiscard]] static auto Digit(const char c) -> unsigned {
+      return static_cast<unsigned>(static_cast<unsigned char>(c) - '0');
+    }
+
+    /**
+     * @brief value * 10^exponent, exact powers up to 1e22
+     */
+    [[nodiscard]] static auto Scale(double value, int exponent) -> double {
+      static constexpr double powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+      };
+
+      while (exponent > 22) {
+        value *= 1e22;
+        exponent -= 22;
+      }
+      while (exponent < -22) {
+        value /= 1e22;
+        exponent += 22;
+      }
+      return exponent >= 0 ? value * powers[exponent]
+                           : value / powers[-exponent];
+    }
+
+    const char* pos;
+    const char* end;
+  };
+
+  /**
+   * @brief Shortest edge line, "0 0 0" and its line break
+   */
+  inline constexpr size_t kMinLineBytes = 6;
+
+  /**
+   * @brief Reads the "V M" header
+   */
+  inline auto read_header(TextScanner& scanner, size_t& V, size_t& M)
+    -> void {
+    if (!scanner.ReadUnsigned(V) || !scanner.ReadUnsigned(M)) {
+      throw "Malformed edge list header";
+    }
+  }
+
+  /**
+   * @brief Parses 'count' "u v w" lines into 'out', returns the end of
+   * what was written
+   */
+  template<typename Edge, typename OutputIt>
+  auto read_edges(
+    TextScanner& scanner,
+    const size_t count,
+    const bool both_directions,
+    OutputIt out
+  ) -> OutputIt {
+    using Weight =
+      std::decay_t<decltype(std::declval<const Edge&>().Weight())>;
+
+    for (size_t e = 0; e < count; ++e) {
+      size_t u, v;
+      double w;
+      if (!scanner.ReadUnsigned(u) || !scanner.ReadUnsigned(v)
+          || !scanner.ReadNumber(w)) {
+        throw "Malformed edge list line";
+      }
+      *out++ = Edge(u, v, static_cast<Weight>(w));
+      if (both_directions) {
+        *out++ = Edge(v, u, static_cast<Weight>(w));
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Whitespace-separated tokens starting in [first, last), where
+   * first follows whitespace (or a range cut)
+   */
+  inline auto count_tokens(const char* first, const char* const last)
+    -> size_t {
+    if (first == last) {
+      return 0;
+    }
+
+    // a token starts wherever a non-space follows a space; no state is
+    // carried between positions, and fixed 64-byte blocks let -O2
+    // vectorise the loop: 90 ms for a 356 MB file, against 620 ms byte by
+    // byte and 170 ms for the memchr line count it replaces
+    constexpr size_t kBlock = 64;
+    const auto* const bytes = reinterpret_cast<const unsigned char*>(first);
+    const size_t size = static_cast<size_t>(last - first);
+    const auto starts = [bytes](const size_t i) -> unsigned {
+      return (bytes[i] > ' ') & (bytes[i - 1] <= ' ');
+    };
+
+    size_t tokens = bytes[0] > ' ';
+    size_t i = 1;
+    for (; i + kBlock <= size; i += kBlock) {
+      unsigned block = 0;
+      for (size_t j = 0; j < kBlock; ++j) {
+        block += starts(i + j);
+      }
+      tokens += block;
+    }
+    for (; i < size; ++i) {
+      tokens += starts(i);
+    }
+    return tokens;
+  }
+}
+
+/**
+ * @brief Parses a whole "V M / u v w" text held in [begin, end)
+ */
+template<typename Edge>
+auto parse_edge_list(
+  const char* begin,
+  const char* end,
+  const bool both_directions = true
+) -> EdgeList<Edge> {
+  detail::TextScanner scanner{begin, end};
+
+  size_t V, M;
+  detail::read_header(scanner, V, M);
+
+  // M comes from the file: a bogus count must not allocate more than the
+  // text could possibly hold
+  const size_t most_lines =
+    static_cast<size_t>(end - scanner.Position()) / detail::kMinLineBytes + 1;
+  const size_t lines = std::min(M, most_lines);
+
+  EdgeList<Edge> list{V, {}};
+  list.edges.reserve(both_directions ? 2 * lines : lines);
+  detail::read_edges<Edge>(
+    scanner, M, both_directions, std::back_inserter(list.edges)
+  );
+  return list;
+}
+
+/**
+ * @brief Maps 'filename' and parses it, see parse_edge_list
+ */
+template<typename Edge>
+auto read_edge_list(const char* filename, const bool both_directions = true)
+  -> EdgeList<Edge> {
+  const MappedFile file{filename};
+  return parse_edge_list<Edge>(
+    file.data(), file.data() + file.size(), both_directions
+  );
+}
+
+/**
+ * @brief Byte ranges the parallel parser aims for: large enough that the
+ * per-range overhead vanishes, small enough to balance a handful of threads
+ */
+inline constexpr size_t kParseChunkBytes = size_t{4} << 20;
+
+/**
+ * @brief parse_edge_list with ranges of about 'chunk_bytes' parsed on 'pool',
+ * one edge per line; same result for any thread count and chunk size
+ */
+template<typename Edge>
+auto parse_edge_list(
+  const char* begin,
+  const char* end,
+  const bool both_directions,
+  ThreadPool& pool,
+  const size_t chunk_bytes = kParseChunkBytes
+) -> EdgeList<Edge> {
+  detail::TextScanner scanner{begin, end};
+
+  size_t V, M;
+  detail::read_header(scanner, V, M);
+
+  // range boundaries, each moved past the number it would split so every
+  // number lies in exactly one range
+  const char* const body = scanner.Position();
+  const size_t bytes = static_cast<size_t>(end - body);
+  const size_t chunks =
+    std::max<size_t>(1, bytes / std::max<size_t>(1, chunk_bytes));
+  if (chunks == 1 || pool.Size() == 1) {
+    // nothing to split: the counting pass would only cost time
+    return parse_edge_list<Edge>(begin, end, both_directions);
+  }
+
+  std::vector<const char*> bounds(chunks + 1, end);
+  bounds[0] = body;
+  for (size_t c = 1; c < chunks; ++c) {
+    const char* cut = std::max(body + bytes / chunks * c, bounds[c - 1]);
+    while (cut != end && static_cast<unsigned char>(cut[-1]) > ' ') {
+      ++cut;
+    }
+    bounds[c] = cut;
+  }
+
+  // numbers per range, so every range knows which edges start in it
+  std::vector<size_t> first_token(chunks + 1, 0);
+  pool.Run(chunks, [&](const size_t c) {
+    first_token[c + 1] = detail::count_tokens(bounds[c], bounds[c + 1]);
+  });
+  for (size_t c = 0; c < chunks; ++c) {
+    first_token[c + 1] += first_token[c];
+  }
+  if (first_token[chunks] / 3 < M) {
+    throw "Malformed edge list line";
+  }
+
+  // every range parses the edges whose first number it holds, the
+  // sequential parser stops after M edges too; errors are reported for the
+  // first bad range
+  const size_t per_line = both_directions ? 2 : 1;
+  EdgeList<Edge> list{V, std::vector<Edge>(per_line * M)};
+  std::vector<const char*> errors(chunks, nullptr);
+  pool.Run(chunks, [&](const size_t c) {
+    const size_t first = std::min((first_token[c] + 2) / 3, M);
+    const size_t last = std::min((first_token[c + 1] + 2) / 3, M);
+    if (first == last) {
+      return;
+    }
+
+    detail::TextScanner range{bounds[c], end};
+    for (size_t skip = first_token[c]; skip < 3 * first; ++skip) {
+      range.SkipToken();
+    }
+    try {
+      detail::read_edges<Edge>(
+        range,
+        last - first,
+        both_directions,
+        list.edges.begin() + per_line * first
+      );
+      // the next range starts at the following number: this one must end
+      // where a number does, as the sequential scanner would find it
+      if (last < M && !range.AtSpace()) {
+        throw "Malformed edge list line";
+      }
+    } catch (const char* error) {
+      errors[c] = error;
+    }
+  });
+  for (const char* error: errors) {
+    if (error) {
+      throw error;
+    }
+  }
+  return list;
+}
+
+/**
+ * @brief Maps 'filename' and parses it on 'pool', see parse_edge_list
+ */
+template<typename Edge>
+auto read_edge_list(
+  const char* filename,
+  const bool both_directions,
+  ThreadPool& pool,
+  const size_t chunk_bytes = kParseChunkBytes
+) -> EdgeList<Edge> {
+  const MappedFile file{filename};
+  return parse_edge_list<Edge>(
+    file.data(), file.data() + file.size(), both_directions, pool, chunk_bytes
+  );
+}
+
+/**
+ * @class EdgeListSource
+ * @brief Streams the edges of a "V M / u v w" file a chunk at a time
+ *
+ * Only the chunk handed to Read() is materialised, the file itself stays in
+ * the (evictable) page cache
+ */
+template<typename EdgeType>
+class EdgeListSource final {
+public:
+
+  typedef EdgeType Edge;
+
+  explicit EdgeListSource(const char* filename, bool both_directions = true):
+      file{filename},
+      scanner{file.data(), file.data() + file.size()},
+      both_directions{both_directions} {
+    detail::read_header(scanner, vertex_count, remaining);
+  }
+
+  /**
+   * @brief V from the header
+   */
+  [[nodiscard]] auto VertexCount() const -> size_t { return vertex_count; }
+
+  /**
+   * @brief Appends up to 'max' edges to 'out' (at least one line's worth),
+   * returns how many, 0 at the end of the file
+   */
+  auto Read(std::vector<Edge>& out, const size_t max) -> size_t {
+    const size_t per_line = both_directions ? 2 : 1;
+    const size_t lines =
+      std::min(remaining, std::max<size_t>(1, max / per_line));
+    detail::read_edges<Edge>(
+      scanner, lines, both_directions, std::back_inserter(out)
+    );
+    remaining -= lines;
+    return lines * per_line;
+  }
+
+private:
+
+  MappedFile file;
+  detail::TextScanner scanner;
+  bool both_directions;
+  size_t vertex_count{0};
+
+  // lines not read yet
+  size_t remaining{0};
+};
+
+#endif
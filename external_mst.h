@@ -0,0 +1,496 @@
+/*!
+  \brief  Streaming (out-of-core) MST for edge sets larger than memory
+
+Implements:
+  external_mst( source, V, options )   MST of every edge the source yields
+  SpanSource                           source over edges already in memory
+
+Modes:
+  SortSpill     every chunk is sorted and spilled to a temporary run file,
+                the runs are k-way merged, at most max_merge_runs at a time,
+                and the last merge feeds one union-find scan
+  ForestMerge   keeps the minimum spanning forest of everything read so far
+                and merges each chunk into it - no disk, one kruskal per chunk
+
+Rationale:
+  only the union-find, the MST itself and one chunk (or the merge buffers)
+  live in memory, sized from ExternalMstOptions::memory_budget, so memory is
+  O(V + chunk). Every edge is checked against V as it is read. Edges are
+  ordered by (weight, position in the stream), the order kruskal() uses, so
+  the result equals kruskal() on the whole stream.
+
+Sets requirements (besides Make/Join/GetRepresentative):
+  kElementBytes   bytes per element, counted against the budget
+  Reset()         reused by ForestMerge for every chunk
+
+Source requirements:
+  typedef Edge                                  trivially copyable edge type
+  size_t Read(std::vector<Edge>& out, size_t max)
+                                  appends up to max edges, 0 at end of stream
+*/
+
+#ifndef EXTERNAL_MST_H
+#define EXTERNAL_MST_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "kruskal.h"
+#include "span.h"
+#include "union_find.h"
+
+/**
+ * @brief Tuning of external_mst
+ */
+struct ExternalMstOptions {
+  enum class Mode {
+    SortSpill,
+    ForestMerge
+  };
+
+  // upper bound on the bytes held in memory at once (approximate)
+  size_t memory_budget{size_t{256} << 20};
+
+  // SortSpill: most runs read by one merge, more are merged in passes
+  size_t max_merge_runs{64};
+
+  Mode mode{Mode::SortSpill};
+};
+
+/**
+ * @class SpanSource
+ * @brief Source reading from edges already in memory (or a mapped file)
+ */
+template<typename EdgeType>
+class SpanSource final {
+public:
+
+  typedef EdgeType Edge;
+
+  explicit SpanSource(Span<const Edge> edges): edges{edges} {}
+
+  auto Read(std::vector<Edge>& out, const size_t max) -> size_t {
+    const size_t count = std::min(max, edges.size() - next);
+    out.insert(out.end(), edges.begin() + next, edges.begin() + next + count);
+    next += count;
+    return count;
+  }
+
+private:
+
+  Span<const Edge> edges;
+  size_t next{0};
+};
+
+namespace detail {
+  /**
+   * @brief Edge plus its position in the stream, the tie breaker
+   */
+  template<typename Edge>
+  struct StreamEdge {
+    Edge edge{};
+    size_t index{0};
+  };
+
+  /**
+   * @class RunFile
+   * @brief Anonymous temporary file holding one sorted run
+   */
+  class RunFile final {
+  public:
+
+    RunFile(): file{std::tmpfile(), &std::fclose} {
+      if (!file) {
+        throw "Cannot create temporary run file";
+      }
+    }
+
+    template<typename Record>
+    auto Write(const Record* records, const size_t count) -> void {
+      if (std::fwrite(records, sizeof(Record), count, file.get()) != count) {
+        throw "Cannot write temporary run file";
+      }
+    }
+
+    auto Rewind() -> void { std::rewind(file.get()); }
+
+    template<typename Record>
+    auto Read(Record* records, const size_t max) -> size_t {
+      return std::fread(records, sizeof(Record), max, file.get());
+    }
+
+  private:
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file;
+  };
+
+  /**
+   * @brief Memory left for edges once union-find and MST are accounted for
+   */
+  template<typename Sets, typename Edge>
+  [[nodiscard]] auto edge_budget(const size_t V, const size_t budget)
+    -> size_t {
+    const size_t fixed = V * (Sets::kElementBytes + sizeof(Edge));
+    if (budget <= fixed) {
+      throw "Memory budget is smaller than the union-find and MST";
+    }
+    return budget - fixed;
+  }
+
+  /**
+   * @brief Throws unless every edge of 'chunk' has both endpoints below V;
+   * the source's V (e.g. a file header) is not trusted to match its edges
+   */
+  template<typename Edge>
+  auto check_endpoints(const std::vector<Edge>& chunk, const size_t V)
+    -> void {
+    for (const Edge& edge: chunk) {
+      if (edge.ID1() >= V || edge.ID2() >= V) {
+        throw "Edge endpoint out of range";
+      }
+    }
+  }
+
+  /**
+   * @brief Sets holding the singletons 0..V-1
+   */
+  template<typename Sets>
+  auto make_singletons(Sets& set, const size_t V) -> void {
+    set.Reset();
+    for (size_t i = 0; i < V; ++i) {
+      set.Make();
+    }
+  }
+
+  /**
+   * @brief k-way merge of sorted runs in (key, stream index) order, each run
+   * read through 'buffer_records' records; stops once visit returns false
+   */
+  template<typename Edge, typename Visit>
+  auto merge_runs(Span<RunFile> runs, const size_t buffer_records, Visit visit)
+    -> void {
+    using Key = SortKeyOf<Edge>;
+    using Record = StreamEdge<Edge>;
+
+    struct Cursor {
+      std::vector<Record> buffer{};
+      size_t next{0};
+    };
+
+    std::vector<Cursor> cursors(runs.size());
+    const auto refill = [&](const size_t run) -> bool {
+      Cursor& cursor = cursors[run];
+      cursor.buffer.resize(buffer_records);
+      cursor.buffer.resize(
+        runs[run].Read(cursor.buffer.data(), buffer_records)
+      );
+      cursor.next = 0;
+      return !cursor.buffer.empty();
+    };
+
+    using HeapItem = std::pair<KeyedIndex<Key>, size_t>;
+    const auto later = [](const HeapItem& a, const HeapItem& b) {
+      return by_key_then_index(b.first, a.first);
+    };
+    std::priority_queue<HeapItem, std::vector<HeapItem>, decltype(later)> heap{
+      later
+    };
+
+    const auto push_head = [&](const size_t run) {
+      const Record& head = cursors[run].buffer[cursors[run].next];
+      heap.push({KeyedIndex<Key>{sort_key(head.edge), head.index}, run});
+    };
+
+    for (size_t run = 0; run < runs.size(); ++run) {
+      runs[run].Rewind();
+      if (refill(run)) {
+        push_head(run);
+      }
+    }
+
+    while (!heap.empty()) {
+      const size_t run = heap.top().second;
+      heap.pop();
+
+      Cursor& cursor = cursors[run];
+      if (!visit(cursor.buffer[cursor.next])) {
+        return;
+      }
+
+      if (++cursor.next < cursor.buffer.size() || refill(run)) {
+        push_head(run);
+      }
+    }
+  }
+
+  /**
+   * @brief One sorted run holding every record of 'runs'
+   */
+  template<typename Edge>
+  auto merge_into_run(Span<RunFile> runs, const size_t buffer_records)
+    -> RunFile {
+    using Record = StreamEdge<Edge>;
+
+    RunFile merged{};
+    std::vector<Record> block{};
+    block.reserve(buffer_records);
+    merge_runs<Edge>(runs, buffer_records, [&](const Record& record) {
+      block.push_back(record);
+      if (block.size() == buffer_records) {
+        merged.Write(block.data(), block.size());
+        block.clear();
+      }
+      return true;
+    });
+    merged.Write(block.data(), block.size());
+    return merged;
+  }
+
+  template<typename Sets, typename Source>
+  auto external_sort_spill(
+    Source& source,
+    const size_t V,
+    const ExternalMstOptions& options
+  ) -> std::vector<typename Source::Edge> {
+    using Edge = typename Source::Edge;
+    using Key = SortKeyOf<Edge>;
+    using Record = StreamEdge<Edge>;
+
+    const size_t available = edge_budget<Sets, Edge>(V, options.memory_budget);
+    const size_t fan_in = std::max<size_t>(2, options.max_merge_runs);
+
+    // a chunk needs its edges and their (key, index) order
+    const size_t chunk_edges = std::max<size_t>(
+      1, available / (sizeof(Edge) + sizeof(KeyedIndex<Key>))
+    );
+
+    // a merge reads fan_in runs and writes (or scans) one block
+    const size_t buffer_records =
+      std::max<size_t>(1, available / (fan_in + 1) / sizeof(Record));
+
+    // runs by merge level: once a level holds fan_in runs they are merged
+    // into one run of the next level, so only a few files per level are
+    // open and every record is rewritten once per level
+    std::vector<std::vector<RunFile>> levels(1);
+    size_t stream_index = 0;
+
+    {
+      std::vector<Edge> chunk{};
+      std::vector<KeyedIndex<Key>> order{};
+      std::vector<Record> block{};
+      chunk.reserve(chunk_edges);
+
+      while (source.Read(chunk, chunk_edges) != 0 || !chunk.empty()) {
+        check_endpoints(chunk, V);
+
+        order.resize(chunk.size());
+        for (size_t i = 0; i < chunk.size(); ++i) {
+          order[i] = KeyedIndex<Key>{sort_key(chunk[i]), i};
+        }
+        if constexpr (std::is_arithmetic_v<WeightOf<Edge>>) {
+          radix_sort(order);
+        } else {
+          std::sort(order.begin(), order.end(), by_key_then_index<Key>);
+        }
+
+        RunFile run{};
+        for (size_t i = 0; i < order.size(); i += 4096) {
+          block.clear();
+          for (size_t j = i; j < std::min(order.size(), i + 4096); ++j) {
+            block.push_back(
+              Record{chunk[order[j].index], stream_index + order[j].index}
+            );
+          }
+          run.Write(block.data(), block.size());
+        }
+        levels[0].push_back(std::move(run));
+
+        stream_index += chunk.size();
+        chunk.clear();
+
+        if (levels[0].size() == fan_in) {
+          // the chunk's memory is handed to the merge buffers meanwhile
+          chunk = std::vector<Edge>{};
+          order = std::vector<KeyedIndex<Key>>{};
+          for (size_t level = 0; levels[level].size() == fan_in; ++level) {
+            if (level + 1 == levels.size()) {
+              levels.emplace_back();
+            }
+            RunFile merged = merge_into_run<Edge>(
+              Span<RunFile>{levels[level]}, buffer_records
+            );
+            levels[level].clear();
+            levels[level + 1].push_back(std::move(merged));
+          }
+          chunk.reserve(chunk_edges);
+        }
+      }
+    }
+
+    // smallest runs first, merged until one pass can take the rest
+    std::vector<RunFile> runs{};
+    for (std::vector<RunFile>& level: levels) {
+      for (RunFile& run: level) {
+        runs.push_back(std::move(run));
+      }
+    }
+    levels.clear();
+    while (runs.size() > fan_in) {
+      RunFile merged = merge_into_run<Edge>(
+        Span<RunFile>{runs.data(), fan_in}, buffer_records
+      );
+      runs.erase(runs.begin(), runs.begin() + static_cast<ptrdiff_t>(fan_in));
+      runs.push_back(std::move(merged));
+    }
+
+    std::vector<Edge> mst{};
+    mst.reserve(V > 0 ? V - 1 : 0);
+    if (V < 2 || runs.empty()) {
+      return mst;
+    }
+
+    Sets set{V};
+    make_singletons(set, V);
+
+    merge_runs<Edge>(
+      Span<RunFile>{runs},
+      buffer_records,
+      tree_scan(
+        set,
+        V - 1,
+        [](const Record& record) { return edge_endpoints(record.edge); },
+        [&](const Record& record) { mst.push_back(record.edge); }
+      )
+    );
+
+    return mst;
+  }
+
+  template<typename Sets, typename Source>
+  auto external_forest_merge(
+    Source& source,
+    const size_t V,
+    const ExternalMstOptions& options
+  ) -> std::vector<typename Source::Edge> {
+    using Edge = typename Source::Edge;
+    using Key = SortKeyOf<Edge>;
+    using Record = StreamEdge<Edge>;
+
+    // forest and chunk are both held as records plus their sort order, the
+    // forest also as the positions kept by the last scan
+    const size_t per_edge =
+      sizeof(Edge) + sizeof(Record) + sizeof(KeyedIndex<Key>);
+    const size_t forest_bytes = V * (per_edge + sizeof(size_t));
+    const size_t available = edge_budget<Sets, Edge>(V, options.memory_budget);
+    if (available <= forest_bytes) {
+      throw "Memory budget is smaller than the spanning forest";
+    }
+    const size_t chunk_edges =
+      std::max<size_t>(1, (available - forest_bytes) / per_edge);
+
+    std::vector<Record> forest{};
+    std::vector<Record> candidates{};
+    std::vector<Edge> chunk{};
+    std::vector<KeyedIndex<Key>> order{};
+    std::vector<size_t> kept{};
+    chunk.reserve(chunk_edges);
+    kept.reserve(V > 0 ? V - 1 : 0);
+    size_t stream_index = 0;
+
+    // one set for every round, Reset() keeps its storage
+    Sets set{V};
+
+    while (source.Read(chunk, chunk_edges) != 0 || !chunk.empty()) {
+      check_endpoints(chunk, V);
+
+      // forest edges keep their stream positions and come first, so
+      // candidates stay in stream order and a stable sort of their
+      // positions is the (key, stream index) order
+      candidates.assign(forest.begin(), forest.end());
+      for (size_t i = 0; i < chunk.size(); ++i) {
+        candidates.push_back(Record{chunk[i], stream_index + i});
+      }
+      stream_index += chunk.size();
+      chunk.clear();
+
+      order.resize(candidates.size());
+      for (size_t i = 0; i < candidates.size(); ++i) {
+        order[i] = KeyedIndex<Key>{sort_key(candidates[i].edge), i};
+      }
+      if constexpr (std::is_arithmetic_v<WeightOf<Edge>>) {
+        radix_sort(order);
+      } else {
+        std::sort(order.begin(), order.end(), by_key_then_index<Key>);
+      }
+
+      // the MSF of (old forest + chunk) is the MSF of everything so far:
+      // an edge dropped here closes a cycle of lighter edges for good
+      make_singletons(set, V);
+      kept.clear();
+      forest.clear();
+      if (V > 1) {
+        visit_in_order(
+          order,
+          tree_scan(
+            set,
+            V - 1,
+            [&](const KeyedIndex<Key>& item) {
+              return edge_endpoints(candidates[item.index].edge);
+            },
+            [&](const KeyedIndex<Key>& item) { kept.push_back(item.index); }
+          )
+        );
+      }
+
+      // back to stream order for the next round
+      std::sort(kept.begin(), kept.end());
+      for (const size_t i: kept) {
+        forest.push_back(candidates[i]);
+      }
+    }
+
+    // kruskal() order: (key, stream index)
+    order.resize(forest.size());
+    for (size_t i = 0; i < forest.size(); ++i) {
+      order[i] = KeyedIndex<Key>{sort_key(forest[i].edge), i};
+    }
+    std::sort(order.begin(), order.end(), by_key_then_index<Key>);
+
+    std::vector<Edge> mst{};
+    mst.reserve(forest.size());
+    for (const KeyedIndex<Key>& item: order) {
+      mst.push_back(forest[item.index].edge);
+    }
+    return mst;
+  }
+}
+
+/**
+ * @brief MST of every edge 'source' yields over vertices 0..V-1, reading it
+ * once and keeping memory within options.memory_budget
+ *
+ * 'Sets' defaults to the compact UnionFind since it is the part of the
+ * footprint that cannot be streamed
+ */
+template<typename Sets = UnionFind, typename Source>
+auto external_mst(
+  Source& source,
+  const size_t vertex_count,
+  const ExternalMstOptions& options = ExternalMstOptions{}
+) -> std::vector<typename Source::Edge> {
+  static_assert(
+    std::is_trivially_copyable_v<typename Source::Edge>,
+    "spilled edges are written as raw bytes"
+  );
+
+  if (options.mode == ExternalMstOptions::Mode::ForestMerge) {
+    return detail::external_forest_merge<Sets>(source, vertex_count, options);
+  }
+  return detail::external_sort_spill<Sets>(source, vertex_count, options);
+}
+
+#endif
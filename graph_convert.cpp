@@ -0,0 +1,117 @@
+// Converts "V M / u v w" edge lists and .dot graphs to the binary graph
+// format (binary_graph.h). Edges are written once, as they appear.
+//
+// usage: graph_convert <input> <output> [--index 32|64]
+//                      [--weight float|double]
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "binary_graph.h"
+#include "dot_reader.h"
+#include "edge_list_reader.h"
+#include "mapped_file.h"
+
+namespace {
+  // parsed edge, full precision until the output type is chosen
+  class TextEdge {
+  public:
+
+    TextEdge(size_t id1 = 0, size_t id2 = 0, double weight = 0):
+        id1(id1), id2(id2), weight(weight) {}
+
+    size_t ID1() const { return id1; }
+
+    size_t ID2() const { return id2; }
+
+    double Weight() const { return weight; }
+
+  private:
+
+    size_t id1;
+    size_t id2;
+    double weight;
+  };
+
+  // dot files start with "graph" / "digraph" (optionally "strict")
+  bool is_dot(const MappedFile& file) {
+    const char* p = file.data();
+    const char* const end = p + file.size();
+    while (p != end && static_cast<unsigned char>(*p) <= ' ') {
+      ++p;
+    }
+    return p != end && (*p < '0' || *p > '9');
+  }
+
+  void usage() {
+    std::fprintf(
+      stderr,
+      "usage: graph_convert <input> <output> [--index 32|64] "
+      "[--weight float|double]\n"
+    );
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    usage();
+    return 1;
+  }
+
+  bool wide_index = false;
+  bool double_weight = false;
+  for (int i = 3; i < argc; i += 2) {
+    const char* value = i + 1 < argc ? argv[i + 1] : "";
+    if (std::strcmp(argv[i], "--index") == 0
+        && (std::strcmp(value, "32") == 0 || std::strcmp(value, "64") == 0)) {
+      wide_index = std::strcmp(value, "64") == 0;
+    } else if (std::strcmp(argv[i], "--weight") == 0
+               && (std::strcmp(value, "float") == 0
+                   || std::strcmp(value, "double") == 0)) {
+      double_weight = std::strcmp(value, "double") == 0;
+    } else {
+      std::fprintf(stderr, "bad option: %s %s\n", argv[i], value);
+      usage();
+      return 1;
+    }
+  }
+
+  try {
+    EdgeList<TextEdge> list{0, {}};
+    {
+      const MappedFile file{argv[1]};
+      const char* const end = file.data() + file.size();
+      list = is_dot(file) ? parse_dot_edges<TextEdge>(file.data(), end)
+                          : parse_edge_list<TextEdge>(file.data(), end, false);
+    }
+
+    if (!wide_index && list.vertex_count > UINT32_MAX) {
+      std::fprintf(stderr, "V does not fit 32 bit indices, use --index 64\n");
+      return 1;
+    }
+
+    const char* output = argv[2];
+    const size_t V = list.vertex_count;
+    if (wide_index && double_weight) {
+      write_binary_graph<uint64_t, double>(output, V, list.edges);
+    } else if (wide_index) {
+      write_binary_graph<uint64_t, float>(output, V, list.edges);
+    } else if (double_weight) {
+      write_binary_graph<uint32_t, double>(output, V, list.edges);
+    } else {
+      write_binary_graph<uint32_t, float>(output, V, list.edges);
+    }
+
+    std::printf(
+      "%s: V=%zu M=%zu -> %s\n",
+      argv[1],
+      list.vertex_count,
+      list.edges.size(),
+      output
+    );
+  } catch (const char* error) {
+    std::fprintf(stderr, "%s\n", error);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,260 @@
+/*!
+  \brief  Seeded synthetic graph generators for benchmarks
+
+Implements:
+  path_with_noise( V, extra, seed )      weight-1 path + heavier random edges
+  grid_2d( width, height, seed )         4-neighbour grid
+  grid_3d( x, y, z, seed )               6-neighbour grid
+  erdos_renyi( V, M, seed )              G(n, m), self loops skipped
+  rmat( scale, M, seed )                 R-MAT power-law, 2^scale vertices
+  complete( V, seed )                    every pair once
+  geometric( V, degree, seed )           random points in the unit square,
+                                         pairs closer than the radius giving
+                                         about 'degree' neighbours per vertex
+
+Rationale:
+  every generator is a pure function of its arguments (mt19937_64 seeded
+  with 'seed', no random_device), so a benchmark case is reproducible
+  across runs and machines. Weights are uniform in [0, 1) unless noted.
+  Edges are produced once each, in one direction, as EdgeList like the
+  file readers return.
+*/
+
+#ifndef GRAPH_GENERATORS_H
+#define GRAPH_GENERATORS_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include "edge_list_reader.h"
+
+namespace detail {
+  /**
+   * @brief Weight stream shared by the generators
+   */
+  class WeightSource final {
+  public:
+
+    explicit WeightSource(const uint64_t seed): gen{seed} {}
+
+    [[nodiscard]] auto Next() -> float { return weight(gen); }
+
+    [[nodiscard]] auto Engine() -> std::mt19937_64& { return gen; }
+
+  private:
+
+    std::mt19937_64 gen;
+    std::uniform_real_distribution<float> weight{0.0f, 1.0f};
+  };
+}
+
+/**
+ * @brief Path 0-1-...-(V-1) of weight 1 plus 'extra' random edges of
+ * weight 2..10, the shape of the driver's random_graph(); the MST is the
+ * path
+ */
+template<typename Edge>
+auto path_with_noise(const size_t V, const size_t extra, const uint64_t seed)
+  -> EdgeList<Edge> {
+  std::mt19937_64 gen{seed};
+  std::uniform_int_distribution<size_t> vertex(0, V - 1);
+  std::uniform_int_distribution<int> weight(2, 10);
+
+  EdgeList<Edge> list{V, {}};
+  list.edges.reserve(V - 1 + extra);
+  for (size_t i = 0; i + 1 < V; ++i) {
+    list.edges.emplace_back(i, i + 1, 1);
+  }
+  for (size_t i = 0; i < extra; ++i) {
+    list.edges.emplace_back(vertex(gen), vertex(gen), weight(gen));
+  }
+  return list;
+}
+
+/**
+ * @brief width x height grid, vertex (x, y) is y * width + x
+ */
+template<typename Edge>
+auto grid_2d(const size_t width, const size_t height, const uint64_t seed)
+  -> EdgeList<Edge> {
+  detail::WeightSource weights{seed};
+
+  EdgeList<Edge> list{width * height, {}};
+  list.edges.reserve(2 * width * height);
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < width; ++x) {
+      const size_t v = y * width + x;
+      if (x + 1 < width) {
+        list.edges.emplace_back(v, v + 1, weights.Next());
+      }
+      if (y + 1 < height) {
+        list.edges.emplace_back(v, v + width, weights.Next());
+      }
+    }
+  }
+  return list;
+}
+
+/**
+ * @brief x * y * z grid, vertex (i, j, k) is (k * y + j) * x + i
+ */
+template<typename Edge>
+auto grid_3d(
+  const size_t x,
+  const size_t y,
+  const size_t z,
+  const uint64_t seed
+) -> EdgeList<Edge> {
+  detail::WeightSource weights{seed};
+
+  EdgeList<Edge> list{x * y * z, {}};
+  list.edges.reserve(3 * x * y * z);
+  for (size_t k = 0; k < z; ++k) {
+    for (size_t j = 0; j < y; ++j) {
+      for (size_t i = 0; i < x; ++i) {
+        const size_t v = (k * y + j) * x + i;
+        if (i + 1 < x) {
+          list.edges.emplace_back(v, v + 1, weights.Next());
+        }
+        if (j + 1 < y) {
+          list.edges.emplace_back(v, v + x, weights.Next());
+        }
+        if (k + 1 < z) {
+          list.edges.emplace_back(v, v + x * y, weights.Next());
+        }
+      }
+    }
+  }
+  return list;
+}
+
+/**
+ * @brief M uniformly random edges (multi-edges possible), may be
+ * disconnected
+ */
+template<typename Edge>
+auto erdos_renyi(const size_t V, const size_t M, const uint64_t seed)
+  -> EdgeList<Edge> {
+  detail::WeightSource weights{seed};
+  std::uniform_int_distribution<size_t> vertex(0, V - 1);
+
+  EdgeList<Edge> list{V, {}};
+  list.edges.reserve(M);
+  while (list.edges.size() < M) {
+    const size_t u = vertex(weights.Engine());
+    const size_t v = vertex(weights.Engine());
+    if (u != v) {
+      list.edges.emplace_back(u, v, weights.Next());
+    }
+  }
+  return list;
+}
+
+/**
+ * @brief R-MAT with the Graph500 quadrant probabilities (0.57, 0.19, 0.19,
+ * 0.05): skewed, power-law degrees, many isolated vertices
+ */
+template<typename Edge>
+auto rmat(const unsigned scale, const size_t M, const uint64_t seed)
+  -> EdgeList<Edge> {
+  detail::WeightSource weights{seed};
+  std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+  EdgeList<Edge> list{size_t{1} << scale, {}};
+  list.edges.reserve(M);
+  while (list.edges.size() < M) {
+    size_t u = 0, v = 0;
+    for (unsigned bit = 0; bit < scale; ++bit) {
+      const double r = coin(weights.Engine());
+      u = (u << 1) | (r >= 0.57 + 0.19);
+      v = (v << 1) | ((r >= 0.57 && r < 0.57 + 0.19) || r >= 0.95);
+    }
+    if (u != v) {
+      list.edges.emplace_back(u, v, weights.Next());
+    }
+  }
+  return list;
+}
+
+/**
+ * @brief K_V, V * (V - 1) / 2 edges
+ */
+template<typename Edge>
+auto complete(const size_t V, const uint64_t seed) -> EdgeList<Edge> {
+  detail::WeightSource weights{seed};
+
+  EdgeList<Edge> list{V, {}};
+  list.edges.reserve(V * (V - 1) / 2);
+  for (size_t u = 0; u < V; ++u) {
+    for (size_t v = u + 1; v < V; ++v) {
+      list.edges.emplace_back(u, v, weights.Next());
+    }
+  }
+  return list;
+}
+
+/**
+ * @brief Random geometric graph: V points in the unit square, an edge of
+ * Euclidean length between every pair closer than r, r chosen for about
+ * 'degree' neighbours per point
+ */
+template<typename Edge>
+auto geometric(const size_t V, const double degree, const uint64_t seed)
+  -> EdgeList<Edge> {
+  std::mt19937_64 gen{seed};
+  std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+
+  const double pi = 3.14159265358979323846;
+  const double r = std::sqrt(degree / (pi * static_cast<double>(V)));
+
+  std::vector<std::pair<double, double>> points(V);
+  for (auto& point: points) {
+    point = {coordinate(gen), coordinate(gen)};
+  }
+
+  // bucket the points into r x r cells, compare with neighbouring cells
+  const size_t cells = std::max<size_t>(1, static_cast<size_t>(1.0 / r));
+  const auto cell_of = [cells](const double c) {
+    return std::min(cells - 1, static_cast<size_t>(c * cells));
+  };
+  std::vector<size_t> start(cells * cells + 1, 0);
+  for (const auto& [x, y]: points) {
+    ++start[cell_of(y) * cells + cell_of(x) + 1];
+  }
+  for (size_t c = 0; c < cells * cells; ++c) {
+    start[c + 1] += start[c];
+  }
+  std::vector<size_t> members(V);
+  std::vector<size_t> fill(start.begin(), start.end() - 1);
+  for (size_t v = 0; v < V; ++v) {
+    const auto& [x, y] = points[v];
+    members[fill[cell_of(y) * cells + cell_of(x)]++] = v;
+  }
+
+  EdgeList<Edge> list{V, {}};
+  list.edges.reserve(static_cast<size_t>(degree / 2 * V));
+  for (size_t u = 0; u < V; ++u) {
+    const auto& [x, y] = points[u];
+    const size_t cx = cell_of(x), cy = cell_of(y);
+    for (size_t ny = cy > 0 ? cy - 1 : 0; ny <= std::min(cells - 1, cy + 1);
+         ++ny) {
+      for (size_t nx = cx > 0 ? cx - 1 : 0; nx <= std::min(cells - 1, cx + 1);
+           ++nx) {
+        const size_t cell = ny * cells + nx;
+        for (size_t i = start[cell]; i < start[cell + 1]; ++i) {
+          const size_t v = members[i];
+          const double dx = points[v].first - x, dy = points[v].second - y;
+          const double d = std::sqrt(dx * dx + dy * dy);
+          if (u < v && d < r) {
+            list.edges.emplace_back(u, v, static_cast<float>(d));
+          }
+        }
+      }
+    }
+  }
+  return list;
+}
+
+#endif
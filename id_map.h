@@ -0,0 +1,225 @@
+/*!
+  \brief  Dense renumbering of sparse 64-bit vertex IDs
+
+Implements:
+  DenseIdMap          open-addressing hash table, external ID -> 0..Size()-1
+  CompactGraph        edges renumbered to dense IDs, Size() / GetEdges() like
+                      the other graphs, Restore() maps MST edges back
+  compact_ids( edges )
+  solve_sparse( edges, solver )
+
+Rationale:
+  every engine indexes its union-find by ID1() / ID2() and sizes it by
+  Size(), so IDs must be exactly 0..V-1. With sparse IDs (hashes, database
+  keys) compact_ids renumbers them in one pass, in order of first
+  appearance, and the engines run unchanged on the result; union-find and
+  edge arrays stay proportional to the real vertex count. The table is one
+  flat array of (ID, index) slots, power-of-two sized and at most half full,
+  probed linearly after a splitmix64 hash: a lookup is usually one cache
+  line, where Graph's std::map walks a tree of separately allocated nodes.
+
+EdgeType requirements:
+  ctor EdgeType( id1, id2, weight )   to renumber an edge
+*/
+
+#ifndef ID_MAP_H
+#define ID_MAP_H
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "span.h"
+
+/**
+ * @class DenseIdMap
+ * @brief Maps arbitrary 64-bit IDs to dense indices in insertion order
+ */
+class DenseIdMap final {
+public:
+
+  /**
+   * @brief Find() result for an ID that was never inserted
+   */
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+  /**
+   * @brief Empty map with room for 'expected' IDs before it grows
+   */
+  explicit DenseIdMap(const size_t expected = 0): slots(), ids() {
+    Reserve(expected);
+  }
+
+  /**
+   * @brief Dense index of 'id', assigning the next one if it is new
+   */
+  auto Insert(const uint64_t id) -> size_t {
+    if (2 * (ids.size() + 1) > slots.size()) {
+      Grow(2 * (ids.size() + 1));
+    }
+
+    Slot& slot = slots[Probe(id)];
+    if (slot.index == kNotFound) {
+      slot = Slot{id, ids.size()};
+      ids.push_back(id);
+    }
+    return slot.index;
+  }
+
+  /**
+   * @brief Dense index of 'id', kNotFound if it was never inserted
+   */
+  [[nodiscard]] auto Find(const uint64_t id) const -> size_t {
+    return slots.empty() ? kNotFound : slots[Probe(id)].index;
+  }
+
+  /**
+   * @brief External ID of a dense index
+   */
+  [[nodiscard]] auto Original(const size_t index) const -> uint64_t {
+    return ids[index];
+  }
+
+  /**
+   * @brief Number of distinct IDs inserted
+   */
+  [[nodiscard]] auto Size() const -> size_t { return ids.size(); }
+
+  /**
+   * @brief Makes room for 'count' IDs without rehashing
+   */
+  auto Reserve(const size_t count) -> void {
+    ids.reserve(count);
+    if (2 * count > slots.size()) {
+      Grow(2 * count);
+    }
+  }
+
+private:
+
+  struct Slot {
+    uint64_t id;
+    size_t index;
+  };
+
+  [[nodiscard]] static auto Hash(uint64_t x) -> uint64_t {
+    // splitmix64 finaliser: consecutive or strided IDs spread evenly
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+  }
+
+  /**
+   * @brief Slot holding 'id', or the empty slot where it would go
+   */
+  [[nodiscard]] auto Probe(const uint64_t id) const -> size_t {
+    const size_t mask = slots.size() - 1;
+    size_t slot = static_cast<size_t>(Hash(id)) & mask;
+    while (slots[slot].index != kNotFound && slots[slot].id != id) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  /**
+   * @brief Rehashes into at least 'minimum' slots (a power of two)
+   */
+  auto Grow(const size_t minimum) -> void {
+    size_t capacity = 16;
+    while (capacity < minimum) {
+      capacity *= 2;
+    }
+
+    slots.assign(capacity, Slot{0, kNotFound});
+    for (size_t index = 0; index < ids.size(); ++index) {
+      slots[Probe(ids[index])] = Slot{ids[index], index};
+    }
+  }
+
+  // open-addressing table, index kNotFound marks an empty slot
+  std::vector<Slot> slots;
+
+  // external ID of every dense index
+  std::vector<uint64_t> ids;
+};
+
+/**
+ * @class CompactGraph
+ * @brief Edge list renumbered to dense IDs, usable by every engine that only
+ * needs Size() and GetEdges() (kruskal, filter_kruskal, boruvka, prim,
+ * minimum_spanning_forest)
+ */
+template<typename EdgeType>
+class CompactGraph final {
+public:
+
+  typedef EdgeType Edge;
+
+  CompactGraph(DenseIdMap ids, std::vector<EdgeType> edges):
+      ids{std::move(ids)}, edges{std::move(edges)} {}
+
+  [[nodiscard]] auto Size() const -> size_t { return ids.Size(); }
+
+  /**
+   * @brief Every edge with dense IDs, in input order
+   */
+  [[nodiscard]] auto GetEdges() const -> Span<const EdgeType> {
+    return Span<const EdgeType>{edges};
+  }
+
+  [[nodiscard]] auto Ids() const -> const DenseIdMap& { return ids; }
+
+  /**
+   * @brief 'dense' (edges of this graph) with the original IDs
+   */
+  [[nodiscard]] auto Restore(const std::vector<EdgeType>& dense) const
+    -> std::vector<EdgeType> {
+    std::vector<EdgeType> restored{};
+    restored.reserve(dense.size());
+    for (const EdgeType& e: dense) {
+      restored.emplace_back(
+        ids.Original(e.ID1()), ids.Original(e.ID2()), e.Weight()
+      );
+    }
+    return restored;
+  }
+
+private:
+
+  DenseIdMap ids;
+  std::vector<EdgeType> edges;
+};
+
+/**
+ * @brief Renumbers the endpoints of 'edges' to 0..V-1 in order of first
+ * appearance
+ */
+template<typename Edge>
+auto compact_ids(const Span<const Edge> edges) -> CompactGraph<Edge> {
+  // sized by the vertices actually seen, not by the edges
+  DenseIdMap ids{};
+
+  std::vector<Edge> dense{};
+  dense.reserve(edges.size());
+  for (const Edge& e: edges) {
+    const size_t id1 = ids.Insert(e.ID1());
+    const size_t id2 = ids.Insert(e.ID2());
+    dense.emplace_back(id1, id2, e.Weight());
+  }
+  return CompactGraph<Edge>{std::move(ids), std::move(dense)};
+}
+
+/**
+ * @brief Runs solver(graph) (e.g. a kruskal call) on the renumbered edges
+ * and returns its edges with the original IDs
+ */
+template<typename Edge, typename Solver>
+auto solve_sparse(const Span<const Edge> edges, Solver&& solver)
+  -> std::vector<Edge> {
+  const CompactGraph<Edge> graph = compact_ids(edges);
+  return graph.Restore(solver(graph));
+}
+
+#endif
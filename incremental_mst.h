@@ -0,0 +1,336 @@
+/*!
+  \brief  Minimum spanning forest maintained under edge insertions
+
+Implements:
+  IncrementalMst( V )     empty forest over vertices 0..V-1
+  Insert( edge )          O(log V) amortized, true if the edge entered
+  InsertBatch( edges )    Insert for each edge in order
+  Forest()                current forest in kruskal() order
+
+Rationale:
+  the forest is kept in a link-cut tree where every tree edge is a node of
+  its own between its endpoints, each splay subtree caching its heaviest
+  edge. A new edge (u,v) either links two trees or closes a cycle; by the
+  cycle property it replaces the heaviest edge on the u-v path when it is
+  lighter, otherwise it is dropped. Nothing but the forest is stored, so
+  a batch costs O(batch * log V) however many edges came before it.
+
+  Edges are ranked by (weight, insertion order), the order kruskal() uses,
+  which makes the forest unique: Forest() equals kruskal() run on every
+  edge inserted so far, in the same order.
+*/
+
+#ifndef INCREMENTAL_MST_H
+#define INCREMENTAL_MST_H
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "kruskal.h"
+
+/**
+ * @class IncrementalMst
+ * @brief Minimum spanning forest of every edge inserted so far
+ */
+template<typename EdgeType>
+class IncrementalMst final {
+public:
+
+  typedef EdgeType Edge;
+
+  /**
+   * @brief Empty forest over 'vertex_count' vertices
+   */
+  explicit IncrementalMst(const size_t vertex_count):
+      vertex_count{vertex_count},
+      nodes(vertex_count > 0 ? 2 * vertex_count - 1 : 0),
+      slots(vertex_count > 0 ? vertex_count - 1 : 0),
+      free_slots{},
+      path{} {
+    free_slots.reserve(slots.size());
+    for (size_t slot = slots.size(); slot > 0; --slot) {
+      free_slots.push_back(slot - 1);
+    }
+  }
+
+  /**
+   * @brief Vertex count
+   */
+  [[nodiscard]] auto Size() const -> size_t { return vertex_count; }
+
+  /**
+   * @brief Edges in the forest
+   */
+  [[nodiscard]] auto EdgeCount() const -> size_t {
+    return slots.size() - free_slots.size();
+  }
+
+  /**
+   * @brief Edges inserted so far, accepted or not
+   */
+  [[nodiscard]] auto Inserted() const -> size_t { return inserted; }
+
+  /**
+   * @brief Adds one edge, true if it is now part of the forest
+   */
+  auto Insert(const Edge& edge) -> bool {
+    const size_t u = edge.ID1();
+    const size_t v = edge.ID2();
+    if (u >= vertex_count || v >= vertex_count) {
+      throw "Edge endpoint out of range";
+    }
+
+    const Rank rank{detail::sort_key(edge), inserted++};
+    if (u == v) {
+      return false;
+    }
+
+    if (FindRoot(u) == FindRoot(v)) {
+      // heaviest edge on the cycle the new edge closes
+      MakeRoot(u);
+      Access(v);
+      const size_t heaviest = nodes[v].best;
+      if (!detail::by_key_then_index(rank, Slot(heaviest).rank)) {
+        return false;
+      }
+      Remove(heaviest);
+    }
+
+    Add(edge, rank);
+    return true;
+  }
+
+  /**
+   * @brief Inserts every edge of 'batch' in order, returns how many entered
+   * the forest (some may have been replaced again by later ones)
+   */
+  template<typename Edges>
+  auto InsertBatch(const Edges& batch) -> size_t {
+    size_t accepted = 0;
+    for (const Edge& edge: batch) {
+      accepted += Insert(edge);
+    }
+    return accepted;
+  }
+
+  /**
+   * @brief Current forest sorted by (weight, insertion order), as kruskal()
+   * returns it
+   */
+  [[nodiscard]] auto Forest() const -> std::vector<Edge> {
+    std::vector<const TreeEdge*> live{};
+    live.reserve(EdgeCount());
+    for (size_t slot = 0; slot < slots.size(); ++slot) {
+      if (nodes[vertex_count + slot].live) {
+        live.push_back(&slots[slot]);
+      }
+    }
+    std::sort(
+      live.begin(),
+      live.end(),
+      [](const TreeEdge* a, const TreeEdge* b) {
+        return detail::by_key_then_index(a->rank, b->rank);
+      }
+    );
+
+    std::vector<Edge> forest{};
+    forest.reserve(live.size());
+    for (const TreeEdge* tree_edge: live) {
+      forest.push_back(tree_edge->edge);
+    }
+    return forest;
+  }
+
+private:
+
+  using Rank = KeyedIndex<detail::SortKeyOf<Edge>>;
+
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
+  /**
+   * @brief Splay tree node: a vertex, or a tree edge when index >= V
+   */
+  struct Node {
+    size_t child[2]{kNone, kNone};
+    size_t parent{kNone};
+
+    // heaviest edge node in this splay subtree, kNone if there is none
+    size_t best{kNone};
+    bool flip{false};
+    bool live{false};
+  };
+
+  struct TreeEdge {
+    Edge edge{};
+    Rank rank{};
+  };
+
+  [[nodiscard]] auto Slot(const size_t node) const -> const TreeEdge& {
+    return slots[node - vertex_count];
+  }
+
+  [[nodiscard]] auto IsRoot(const size_t x) const -> bool {
+    const size_t p = nodes[x].parent;
+    return p == kNone || (nodes[p].child[0] != x && nodes[p].child[1] != x);
+  }
+
+  auto Push(const size_t x) -> void {
+    Node& node = nodes[x];
+    if (node.flip) {
+      std::swap(node.child[0], node.child[1]);
+      for (const size_t c: node.child) {
+        if (c != kNone) {
+          nodes[c].flip = !nodes[c].flip;
+        }
+      }
+      node.flip = false;
+    }
+  }
+
+  /**
+   * @brief Heavier of two edge nodes (kNone is lighter than anything)
+   */
+  [[nodiscard]] auto Heavier(const size_t a, const size_t b) const -> size_t {
+    if (a == kNone || b == kNone) {
+      return a == kNone ? b : a;
+    }
+    return detail::by_key_then_index(Slot(a).rank, Slot(b).rank) ? b : a;
+  }
+
+  auto Pull(const size_t x) -> void {
+    Node& node = nodes[x];
+    size_t best = x >= vertex_count ? x : kNone;
+    for (const size_t c: node.child) {
+      if (c != kNone) {
+        best = Heavier(best, nodes[c].best);
+      }
+    }
+    node.best = best;
+  }
+
+  auto Rotate(const size_t x) -> void {
+    const size_t p = nodes[x].parent;
+    const size_t g = nodes[p].parent;
+    const int side = nodes[p].child[1] == x;
+
+    const size_t moved = nodes[x].child[1 - side];
+    nodes[p].child[side] = moved;
+    if (moved != kNone) {
+      nodes[moved].parent = p;
+    }
+
+    if (!IsRoot(p)) {
+      nodes[g].child[nodes[g].child[1] == p] = x;
+    }
+    nodes[x].parent = g;
+    nodes[x].child[1 - side] = p;
+    nodes[p].parent = x;
+
+    Pull(p);
+    Pull(x);
+  }
+
+  auto Splay(const size_t x) -> void {
+    // pending flips are pushed top-down before rotating
+    path.clear();
+    path.push_back(x);
+    for (size_t y = x; !IsRoot(y); y = nodes[y].parent) {
+      path.push_back(nodes[y].parent);
+    }
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+      Push(*it);
+    }
+
+    while (!IsRoot(x)) {
+      const size_t p = nodes[x].parent;
+      if (!IsRoot(p)) {
+        const size_t g = nodes[p].parent;
+        const bool zigzig =
+          (nodes[g].child[0] == p) == (nodes[p].child[0] == x);
+        Rotate(zigzig ? p : x);
+      }
+      Rotate(x);
+    }
+  }
+
+  /**
+   * @brief Makes the root-to-x path preferred, x ends up at the splay root
+   */
+  auto Access(const size_t x) -> void {
+    size_t last = kNone;
+    for (size_t y = x; y != kNone; y = nodes[y].parent) {
+      Splay(y);
+      nodes[y].child[1] = last;
+      Pull(y);
+      last = y;
+    }
+    Splay(x);
+  }
+
+  auto MakeRoot(const size_t x) -> void {
+    Access(x);
+    nodes[x].flip = !nodes[x].flip;
+  }
+
+  [[nodiscard]] auto FindRoot(size_t x) -> size_t {
+    Access(x);
+    for (Push(x); nodes[x].child[0] != kNone; Push(x)) {
+      x = nodes[x].child[0];
+    }
+    Splay(x);
+    return x;
+  }
+
+  /**
+   * @brief Links x (a tree root after MakeRoot) under y
+   */
+  auto Link(const size_t x, const size_t y) -> void {
+    MakeRoot(x);
+    nodes[x].parent = y;
+  }
+
+  /**
+   * @brief Removes the tree edge between adjacent nodes x and y
+   */
+  auto Cut(const size_t x, const size_t y) -> void {
+    MakeRoot(x);
+    Access(y);
+    nodes[y].child[0] = kNone;
+    nodes[x].parent = kNone;
+    Pull(y);
+  }
+
+  auto Add(const Edge& edge, const Rank& rank) -> void {
+    const size_t slot = free_slots.back();
+    free_slots.pop_back();
+    slots[slot] = TreeEdge{edge, rank};
+
+    const size_t x = vertex_count + slot;
+    nodes[x] = Node{};
+    nodes[x].live = true;
+    Pull(x);
+    Link(x, edge.ID1());
+    Link(x, edge.ID2());
+  }
+
+  auto Remove(const size_t x) -> void {
+    const Edge& edge = Slot(x).edge;
+    Cut(x, edge.ID1());
+    Cut(x, edge.ID2());
+    nodes[x].live = false;
+    free_slots.push_back(x - vertex_count);
+  }
+
+  size_t vertex_count;
+
+  // V vertex nodes followed by V-1 tree edge nodes
+  std::vector<Node> nodes;
+  std::vector<TreeEdge> slots;
+  std::vector<size_t> free_slots;
+
+  // scratch for Splay
+  std::vector<size_t> path;
+
+  size_t inserted{0};
+};
+
+#endif
@@ -3,48 +3,634 @@
 
 #include "disjoint_sets.h"
 #include "graph.h"
+#include "mst_stats.h"
+#include "parallel_sort.h"
+#include "radix_sort.h"
+#include "span.h"
+#include "thread_pool.h"
+#include "union_find.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace detail {
+  /**
+   * @brief Type returned by Edge::Weight()
+   */
+  template<typename Edge>
+  using WeightOf = std::decay_t<decltype(std::declval<const Edge&>().Weight())>;
+
+  /**
+   * @brief Key edges are ordered by: radix key for arithmetic weights, the
+   * weight itself otherwise
+   */
+  template<typename Edge>
+  using SortKeyOf = typename std::conditional_t<
+    std::is_arithmetic_v<WeightOf<Edge>>,
+    RadixKeyOf<WeightOf<Edge>>,
+    std::common_type<WeightOf<Edge>>>::type;
+
+  template<typename Edge>
+  [[nodiscard]] auto sort_key(const Edge& edge) -> SortKeyOf<Edge> {
+    if constexpr (std::is_arithmetic_v<WeightOf<Edge>>) {
+      return to_radix_key(edge.Weight());
+    } else {
+      return edge.Weight();
+    }
+  }
+
+  /**
+   * @brief Total order used by every engine: weight, then input position
+   */
+  template<typename Key, typename Index = size_t>
+  [[nodiscard]] auto by_key_then_index(
+    const KeyedIndex<Key, Index>& a,
+    const KeyedIndex<Key, Index>& b
+  ) -> bool {
+    return a.key < b.key || (!(b.key < a.key) && a.index < b.index);
+  }
+
+  template<typename Container, typename = void>
+  struct IsContiguous : std::false_type {};
+
+  template<typename Container>
+  struct IsContiguous<
+    Container,
+    std::void_t<decltype(std::declval<const Container&>().data())>>
+      : std::true_type {};
+
+  /**
+   * @brief Random-access edges of the graph: GetEdges() itself when it is
+   * contiguous (CsrGraph), otherwise a copy of the list (Graph)
+   */
+  template<typename GraphType>
+  [[nodiscard]] auto random_access_edges(const GraphType& graph) {
+    using Edges = std::decay_t<decltype(graph.GetEdges())>;
+    using Edge = typename GraphType::Edge;
+
+    if constexpr (IsContiguous<Edges>::value) {
+      return Span<const Edge>{graph.GetEdges().data(), graph.GetEdges().size()};
+    } else {
+      return std::vector<Edge>{
+        graph.GetEdges().begin(), graph.GetEdges().end()
+      };
+    }
+  }
+
+  /**
+   * @brief Type Policy::Key returns for Edge
+   */
+  template<typename Policy, typename Edge>
+  using PolicyKeyOf =
+    std::decay_t<decltype(Policy::Key(std::declval<const Edge&>()))>;
+
+  /**
+   * @brief Calls visit(item) for each item of 'order' until it returns false
+   */
+  template<typename Order, typename Visitor>
+  auto visit_in_order(const Order& order, Visitor&& visit) -> void {
+    MST_STATS_PHASE_BEGIN(scan);
+    size_t position = 0;
+    for (; position < order.size(); ++position) {
+      if (!visit(order[position])) {
+        break;
+      }
+    }
+    MST_STATS_PHASE_END(scan);
+
+    MST_STATS_ADD(
+      edges_examined, position < order.size() ? position + 1 : position
+    );
+    MST_STATS_SET(
+      early_exit_index,
+      position < order.size() ? position : MstStats::kNoEarlyExit
+    );
+  }
+
+  /**
+   * @brief Calls 'visit' on edges in non-decreasing Policy::Key order until
+   * it returns false, ties are visited in input order
+   *
+   * Only positions are sorted, the edges stay where they are. The sort is
+   * picked from the key type at compile time:
+   *   integers of at most 16 bits   one counting pass, positions only
+   *   other arithmetic types        radix sort of (radix key, position)
+   *   anything else                 comparison sort of (key, position)
+   */
+  template<typename Policy, typename Edges, typename Visitor>
+  auto for_each_by_key(const Edges& edges, Visitor&& visit) -> void {
+    using Edge = typename Edges::value_type;
+    using Index = typename Policy::Index;
+    using Key = PolicyKeyOf<Policy, Edge>;
+
+    MST_STATS_PHASE_BEGIN(sort);
+    if constexpr (std::is_integral_v<Key> && sizeof(Key) <= 2) {
+      constexpr int64_t lowest = std::numeric_limits<Key>::min();
+      const std::vector<Index> order = counting_sort_order<Index>(
+        edges.size(),
+        size_t{1} << (8 * sizeof(Key)),
+        [&](const size_t i) {
+          return static_cast<size_t>(
+            static_cast<int64_t>(Policy::Key(edges[i])) - lowest
+          );
+        }
+      );
+      MST_STATS_PHASE_END(sort);
+
+      visit_in_order(order, [&](const Index i) { return visit(edges[i]); });
+    } else if constexpr (std::is_arithmetic_v<Key>) {
+      using Item = KeyedIndex<RadixKey<Key>, Index>;
+      std::vector<Item> order(edges.size());
+      for (size_t i = 0; i < edges.size(); ++i) {
+        order[i] =
+          Item{to_radix_key(Policy::Key(edges[i])), static_cast<Index>(i)};
+      }
+      radix_sort(order);
+      MST_STATS_PHASE_END(sort);
+
+      visit_in_order(
+        order, [&](const Item& item) { return visit(edges[item.index]); }
+      );
+    } else {
+      using Item = KeyedIndex<Key, Index>;
+      std::vector<Item> order{};
+      order.reserve(edges.size());
+      for (size_t i = 0; i < edges.size(); ++i) {
+        order.push_back(Item{Policy::Key(edges[i]), static_cast<Index>(i)});
+      }
+      std::sort(order.begin(), order.end(), by_key_then_index<Key, Index>);
+      MST_STATS_PHASE_END(sort);
+
+      visit_in_order(
+        order, [&](const Item& item) { return visit(edges[item.index]); }
+      );
+    }
+  }
+
+  /**
+   * @brief Endpoints and input position of an edge, 32 bits each
+   */
+  struct CompactEdge {
+    uint32_t u;
+    uint32_t v;
+    uint32_t index;
+  };
+
+  /**
+   * @brief Whether for_each_compact_by_key can take Policy's keys:
+   * arithmetic, too wide for for_each_by_key's counting pass and at most 4
+   * bytes. With 8-byte keys the records would be 24 bytes, as large as the
+   * edges they save the scan from reading, for twice the sort traffic
+   */
+  template<typename Policy, typename Edge>
+  inline constexpr bool kCompactKey =
+    std::is_arithmetic_v<PolicyKeyOf<Policy, Edge>>
+    && sizeof(PolicyKeyOf<Policy, Edge>) <= 4
+    && !(std::is_integral_v<PolicyKeyOf<Policy, Edge>>
+         && sizeof(PolicyKeyOf<Policy, Edge>) <= 2);
+
+  /**
+   * @brief Whether vertex IDs and edge positions fit a CompactEdge
+   */
+  [[nodiscard]] inline auto fits_compact(
+    const size_t vertices,
+    const size_t edges
+  ) -> bool {
+    constexpr size_t limit = std::numeric_limits<uint32_t>::max();
+    return vertices <= limit && edges <= limit;
+  }
+
+  /**
+   * @brief for_each_by_key for kCompactKey policies on fits_compact()
+   * graphs, calling visit(edge) with a CompactEdge
+   *
+   * The radix sort carries each edge's endpoints along with its key (16 byte
+   * records), so the scan reads the sorted array front to
+   * back and never gathers Edge objects; only accepted edges are looked up
+   * by position.
+   */
+  template<typename Policy, typename Edges, typename Visitor>
+  auto for_each_compact_by_key(const Edges& edges, Visitor&& visit) -> void {
+    using Key = PolicyKeyOf<Policy, typename Edges::value_type>;
+    using Item = KeyedIndex<RadixKey<Key>, CompactEdge>;
+
+    MST_STATS_PHASE_BEGIN(sort);
+    std::vector<Item> order(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+      const auto& edge = edges[i];
+      order[i] = Item{
+        to_radix_key(Policy::Key(edge)),
+        CompactEdge{
+          static_cast<uint32_t>(edge.ID1()),
+          static_cast<uint32_t>(edge.ID2()),
+          static_cast<uint32_t>(i)
+        }
+      };
+    }
+    radix_sort(order);
+    MST_STATS_PHASE_END(sort);
+
+    visit_in_order(order, [&](const Item& item) { return visit(item.index); });
+  }
+
+  /**
+   * @brief Visitor for the Kruskal scan shared by every engine that scans
+   * a sorted order: joins the endpoints(item) of each item that links two
+   * sets, hands it to accept(item) and stops after 'target' joins. Only an
+   * accepted item can end the scan, so target must be positive whenever an
+   * edge could be accepted
+   */
+  template<typename Sets, typename Endpoints, typename Accept>
+  [[nodiscard]] auto tree_scan(
+    Sets& set,
+    const size_t target,
+    Endpoints&& endpoints,
+    Accept&& accept
+  ) {
+    return [&set,
+            target,
+            accepted = size_t{0},
+            endpoints = std::forward<Endpoints>(endpoints),
+            accept = std::forward<Accept>(accept)](const auto& item) mutable {
+      const auto [u, v] = endpoints(item);
+      const size_t rep1 = set.GetRepresentative(u);
+      const size_t rep2 = set.GetRepresentative(v);
+
+      if (rep1 != rep2) {
+        set.Join(u, v);
+        accept(item);
+        return ++accepted != target;
+      }
+      return true;
+    };
+  }
+
+  /**
+   * @brief endpoints() of tree_scan for Edge items
+   */
+  template<typename Edge>
+  [[nodiscard]] auto edge_endpoints(const Edge& edge)
+    -> std::pair<size_t, size_t> {
+    return {edge.ID1(), edge.ID2()};
+  }
+
+  /**
+   * @brief tree_scan over 'edges' in Policy::Key order, through the compact
+   * records when the keys and sizes allow and for_each_by_key otherwise;
+   * accept(edge) gets every joined edge
+   */
+  template<typename Policy, typename Edges, typename Sets, typename Accept>
+  auto tree_scan_by_key(
+    const Edges& edges,
+    Sets& set,
+    const size_t vertices,
+    const size_t target,
+    Accept&& accept
+  ) -> void {
+    using Edge = typename Edges::value_type;
+
+    if constexpr (kCompactKey<Policy, Edge>) {
+      if (fits_compact(vertices, edges.size())) {
+        for_each_compact_by_key<Policy>(
+          edges,
+          tree_scan(
+            set,
+            target,
+            [](const CompactEdge& edge) {
+              return std::pair<size_t, size_t>{edge.u, edge.v};
+            },
+            [&](const CompactEdge& edge) { accept(edges[edge.index]); }
+          )
+        );
+        return;
+      }
+    }
+
+    for_each_by_key<Policy>(
+      edges,
+      tree_scan(set, target, edge_endpoints<Edge>, [&](const Edge& edge) {
+        accept(edge);
+      })
+    );
+  }
+
+  /**
+   * @brief Ranges at or below this size are sorted and scanned directly
+   */
+  inline constexpr size_t kFilterKruskalBase = 1024;
+
+  /**
+   * @brief Introsort-style recursion limit for 'n' edges, 2 * log2(n)
+   */
+  [[nodiscard]] inline auto filter_kruskal_depth(size_t n) -> size_t {
+    size_t depth = 0;
+    for (; n > 1; n >>= 1) {
+      depth += 2;
+    }
+    return depth;
+  }
+
+  template<typename Edges, typename Sets>
+  struct FilterKruskalState {
+    const Edges& edges;
+    Sets& set;
+    std::vector<typename Edges::value_type>& mst;
+    size_t target;
+
+    // connectivity tests, by the scans and by the filter partitions
+    size_t examined{0};
+
+    // edge that completed the tree, once mst.size() == target
+    size_t completed{0};
+  };
+
+  /**
+   * @brief Recursive step of filter_kruskal over [first, last)
+   */
+  template<typename Edges, typename Sets, typename Iterator>
+  auto filter_kruskal_step(
+    FilterKruskalState<Edges, Sets>& state,
+    const Iterator first,
+    const Iterator last,
+    const size_t depth
+  ) -> void {
+    using Edge = typename Edges::value_type;
+    using Item = typename std::iterator_traits<Iterator>::value_type;
+
+    if (state.mst.size() >= state.target || first == last) {
+      return;
+    }
+
+    const auto connected = [&](const Item& item) {
+      const Edge& edge = state.edges[item.index];
+      return state.set.GetRepresentative(edge.ID1())
+          == state.set.GetRepresentative(edge.ID2());
+    };
+
+    // small (or badly pivoted) range: plain kruskal
+    if (static_cast<size_t>(last - first) <= kFilterKruskalBase
+        || depth == 0) {
+      std::sort(first, last, by_key_then_index<decltype(Item::key)>);
+      for (Iterator it = first; it != last; ++it) {
+        if (!connected(*it)) {
+          const Edge& edge = state.edges[it->index];
+          state.set.Join(edge.ID1(), edge.ID2());
+          state.mst.push_back(edge);
+
+          if (state.mst.size() == state.target) {
+            state.examined += static_cast<size_t>(it - first) + 1;
+            state.completed = it->index;
+            return;
+          }
+        }
+      }
+      state.examined += static_cast<size_t>(last - first);
+      return;
+    }
+
+    // median of three, keys are distinct (index breaks ties) so both halves
+    // are non-empty
+    Item samples[3] = {*first, *(first + (last - first) / 2), *(last - 1)};
+    std::sort(
+      std::begin(samples),
+      std::end(samples),
+      by_key_then_index<decltype(Item::key)>
+    );
+    const Item pivot = samples[1];
+
+    const Iterator middle = std::partition(first, last, [&](const Item& item) {
+      return !by_key_then_index(pivot, item);
+    });
+
+    filter_kruskal_step(state, first, middle, depth - 1);
+
+    if (state.mst.size() >= state.target) {
+      return;
+    }
+
+    // light edges are settled, drop heavy ones that can no longer be used
+    state.examined += static_cast<size_t>(last - middle);
+    const Iterator useful = std::partition(
+      middle,
+      last,
+      [&](const Item& item) { return !connected(item); }
+    );
+
+    filter_kruskal_step(state, middle, useful, depth - 1);
+  }
+}
+
+/**
+ * @brief Compile-time configuration of kruskal_with()
+ *
+ * Key(edge)  what edges are ordered by, its return type is the weight type
+ *            and picks the sort (see detail::for_each_by_key)
+ * Index      width of vertex IDs and edge positions in the sort records,
+ *            uint32_t halves them for graphs below 2^32 edges and vertices
+ * Sets       union-find backend, e.g. BasicUnionFind<uint32_t>
+ *
+ * Policies are plain structs, any type with these three members works
+ */
+template<
+  typename Edge,
+  typename SetsType = DisjointSets,
+  typename IndexType = size_t>
+struct KruskalPolicy {
+  using Sets = SetsType;
+  using Index = IndexType;
+
+  [[nodiscard]] static auto Key(const Edge& edge) { return edge.Weight(); }
+};
+
+/**
+ * @brief kruskal() with the key, index width and union-find backend taken
+ * from 'Policy' - features a policy does not use are compiled out
+ */
+template<typename Policy, typename GraphType>
+auto kruskal_with(const GraphType& graph)
+  -> std::vector<typename GraphType::Edge> {
+  using Edge = typename GraphType::Edge;
+  using Index = typename Policy::Index;
+  using Sets = typename Policy::Sets;
+  static_assert(std::is_unsigned_v<Index>, "indices are unsigned");
+
+  const size_t size = graph.Size();
+
+  MST_STATS_PHASE_BEGIN(copy);
+  const auto edges = detail::random_access_edges(graph);
+  MST_STATS_PHASE_END(copy);
+
+  if constexpr (sizeof(Index) < sizeof(size_t)) {
+    constexpr size_t limit = std::numeric_limits<Index>::max();
+    if (size > limit || edges.size() > limit) {
+      throw "graph is too large for the policy's index width";
+    }
+  }
+
+  std::vector<Edge> mst{};
+  const size_t target = size > 0 ? size - 1 : 0;
+  mst.reserve(target);
+
+  Sets set{size};
+
+  for (size_t i = 0; i < size; i++) {
+    set.Make();
+  }
+
+  // Step 4: Add edges to MST if they don't form a cycle
+  detail::tree_scan_by_key<Policy>(
+    edges, set, size, target, [&](const Edge& edge) { mst.push_back(edge); }
+  );
+
+  MST_STATS_ADD(edges_accepted, mst.size());
+  return mst;
+}
 
 /**
  * @brief Performs kruskal algorithm on given graph for MST
+ *
+ * Works with any graph exposing Size() and an iterable GetEdges(), e.g. Graph
+ * (edges in a list, copied once) or CsrGraph (edges in one contiguous array,
+ * used in place). 'Sets' is
+ * the union-find backend: DisjointSets (quick find) or UnionFind (flat
+ * parent array), e.g. kruskal<UnionFind>(graph)
+ */
+template<typename Sets = DisjointSets, typename GraphType>
+auto kruskal(const GraphType& graph) -> std::vector<typename GraphType::Edge> {
+  return kruskal_with<KruskalPolicy<typename GraphType::Edge, Sets>>(graph);
+}
+
+/**
+ * @brief Kruskal with the edge sort spread over a thread pool
+ *
+ * Contiguous edge storage is used in place (a Graph's list is copied, a list
+ * walk cannot be split), keys are built in parallel and sorted with a
+ * parallel sample sort, then the union-find scan runs over the result. Same
+ * (weight, input position) order and result as kruskal().
  */
-template<typename Vertex, typename Edge>
-auto kruskal(const Graph<Vertex, Edge>& graph) -> std::vector<Edge> {
+template<typename Sets = DisjointSets, typename GraphType>
+auto kruskal(const GraphType& graph, ThreadPool& pool)
+  -> std::vector<typename GraphType::Edge> {
+  using Edge = typename GraphType::Edge;
+  using Key = detail::SortKeyOf<Edge>;
+
   const size_t size = graph.Size();
 
   std::vector<Edge> mst{};
-  mst.reserve(size - 1);
+  mst.reserve(size > 0 ? size - 1 : 0);
 
-  std::vector<Edge> edges{graph.GetEdges().begin(), graph.GetEdges().end()};
+  MST_STATS_PHASE_BEGIN(copy);
+  const auto edges = detail::random_access_edges(graph);
+  MST_STATS_PHASE_END(copy);
 
-  std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
-    return a.Weight() < b.Weight();
+  MST_STATS_PHASE_BEGIN(sort);
+  std::vector<KeyedIndex<Key>> order(edges.size());
+  pool.ParallelFor(order.size(), [&](size_t begin, size_t end, size_t) {
+    for (size_t i = begin; i < end; ++i) {
+      order[i] = KeyedIndex<Key>{detail::sort_key(edges[i]), i};
+    }
   });
 
-  DisjointSets set{size};
+  // buckets receive their items in index order, so a stable radix sort
+  // orders them by (key, index)
+  if constexpr (std::is_arithmetic_v<detail::WeightOf<Edge>>) {
+    parallel_sort(
+      order,
+      pool,
+      detail::by_key_then_index<Key>,
+      [](std::vector<KeyedIndex<Key>>& bucket) { radix_sort(bucket); }
+    );
+  } else {
+    parallel_sort(order, pool, detail::by_key_then_index<Key>);
+  }
+  MST_STATS_PHASE_END(sort);
+
+  Sets set{size};
 
   for (size_t i = 0; i < size; i++) {
     set.Make();
   }
 
-  // Step 4: Add edges to MST if they don't form a cycle
-  for (const Edge& edge: edges) {
+  detail::visit_in_order(
+    order,
+    detail::tree_scan(
+      set,
+      size > 0 ? size - 1 : 0,
+      [&](const KeyedIndex<Key>& item) {
+        return detail::edge_endpoints(edges[item.index]);
+      },
+      [&](const KeyedIndex<Key>& item) { mst.push_back(edges[item.index]); }
+    )
+  );
 
-    const size_t u = edge.ID1();
-    const size_t v = edge.ID2();
+  MST_STATS_ADD(edges_accepted, mst.size());
+  return mst;
+}
 
-    const size_t rep1 = set.GetRepresentative(u);
-    const size_t rep2 = set.GetRepresentative(v);
+/**
+ * @brief Filter-Kruskal: same result as kruskal(), but partitions edges
+ * around a pivot, solves the light half first and discards heavy edges
+ * that already close a cycle before they are ever sorted
+ */
+template<typename Sets = DisjointSets, typename GraphType>
+auto filter_kruskal(const GraphType& graph)
+  -> std::vector<typename GraphType::Edge> {
+  using Edge = typename GraphType::Edge;
+  using Key = detail::SortKeyOf<Edge>;
 
-    if (rep1 != rep2) {
-      set.Join(u, v);
-      mst.push_back(edge);
+  const size_t size = graph.Size();
 
-      if (mst.size() == size - 1) {
-        break;
-      }
-    }
+  std::vector<Edge> mst{};
+  mst.reserve(size > 0 ? size - 1 : 0);
+
+  MST_STATS_PHASE_BEGIN(copy);
+  const auto edges = detail::random_access_edges(graph);
+  MST_STATS_PHASE_END(copy);
+
+  std::vector<KeyedIndex<Key>> order(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    order[i] = KeyedIndex<Key>{detail::sort_key(edges[i]), i};
   }
 
+  Sets set{size};
+
+  for (size_t i = 0; i < size; i++) {
+    set.Make();
+  }
+
+  const size_t depth = detail::filter_kruskal_depth(order.size());
+  detail::FilterKruskalState<std::decay_t<decltype(edges)>, Sets> state{
+    edges, set, mst, size > 0 ? size - 1 : 0
+  };
+  // partitioning and sorting are interleaved, both count as scan time
+  MST_STATS_PHASE_BEGIN(scan);
+  detail::filter_kruskal_step(state, order.begin(), order.end(), depth);
+  MST_STATS_PHASE_END(scan);
+
+  MST_STATS_ADD(edges_examined, state.examined);
+  MST_STATS_ADD(edges_accepted, mst.size());
+  if constexpr (kMstInstrumented) {
+    // the completing edge's position in weight order: the edges ordering
+    // before it, filtered ones included
+    size_t position = MstStats::kNoEarlyExit;
+    if (state.target > 0 && mst.size() == state.target) {
+      const KeyedIndex<Key> last{
+        detail::sort_key(edges[state.completed]), state.completed
+      };
+      position = static_cast<size_t>(std::count_if(
+        order.begin(),
+        order.end(),
+        [&](const KeyedIndex<Key>& item) {
+          return detail::by_key_then_index(item, last);
+        }
+      ));
+    }
+    MST_STATS_SET(early_exit_index, position);
+  }
   return mst;
 }
 
@@ -0,0 +1,45 @@
+#include "mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const char* filename) {
+  const int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    throw "Cannot open input file";
+  }
+
+  struct stat info{};
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    throw "Cannot open input file";
+  }
+  length = static_cast<size_t>(info.st_size);
+
+  // mmap rejects empty mappings, an empty file is simply no bytes
+  if (length != 0) {
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      throw "Cannot map input file";
+    }
+    madvise(mapping, length, MADV_SEQUENTIAL);
+    bytes = static_cast<const char*>(mapping);
+  }
+
+  // the mapping stays valid after the descriptor is closed
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (bytes) {
+    munmap(const_cast<char*>(bytes), length);
+  }
+}
+
+auto MappedFile::data() const -> const char* { return bytes; }
+
+auto MappedFile::size() const -> size_t { return length; }
+
+auto MappedFile::empty() const -> bool { return length == 0; }
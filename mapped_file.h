@@ -0,0 +1,53 @@
+/*!
+  \brief  Read-only memory mapping of a whole file (POSIX mmap)
+
+Implements:
+  ctor (filename)   maps the file, throws if it cannot be opened
+  data / size / empty
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <cstdlib>
+
+/**
+ * @class MappedFile
+ * @brief Owns a read-only, page-cache backed view of a file
+ */
+class MappedFile final {
+public:
+
+  /**
+   * @brief Maps 'filename' for sequential reading
+   */
+  explicit MappedFile(const char* filename);
+
+  /**
+   * @brief Unmaps the file
+   */
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+
+  /**
+   * @brief First byte of the file (nullptr for an empty file)
+   */
+  [[nodiscard]] auto data() const -> const char*;
+
+  /**
+   * @brief File size in bytes
+   */
+  [[nodiscard]] auto size() const -> size_t;
+
+  [[nodiscard]] auto empty() const -> bool;
+
+private:
+
+  const char* bytes{nullptr};
+  size_t length{0};
+};
+
+#endif
@@ -0,0 +1,169 @@
+/*!
+  \brief  Opt-in instrumentation of the MST hot paths
+
+Implements:
+  MstStats         phase timings (copy / sort / scan), edges examined and
+                   accepted, early-exit position, nodes relabelled by Join,
+                   histogram of find path lengths
+  mst_stats()      this thread's counters
+  Add( other )     sums another thread's counters into these
+  write_json( os, stats )
+
+Rationale:
+  the MST_STATS_* macros are what the engines and union-find backends call.
+  Without MST_INSTRUMENT defined (cmake -DMST_INSTRUMENT=ON, or
+  -DMST_INSTRUMENT on the command line) they expand to nothing, so the
+  default build carries no counters, clocks or branches. MstStats itself
+  always exists so code reading it compiles either way (it stays zero).
+  Counters are per thread and add up across runs until Reset(). ThreadPool
+  adds what its workers counted during a Run() to the calling thread, so
+  pool engines report in one place; worker phase times add up as thread
+  time, not wall time.
+*/
+
+#ifndef MST_STATS_H
+#define MST_STATS_H
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <ostream>
+
+/**
+ * @brief true when the build collects MstStats
+ */
+#ifdef MST_INSTRUMENT
+inline constexpr bool kMstInstrumented = true;
+#else
+inline constexpr bool kMstInstrumented = false;
+#endif
+
+/**
+ * @brief Counters collected while MST_INSTRUMENT is defined
+ */
+struct MstStats {
+  // path lengths >= the last bucket are counted in the last bucket
+  static constexpr size_t kFindBuckets = 16;
+
+  // early_exit_index when the last run scanned every edge
+  static constexpr size_t kNoEarlyExit = static_cast<size_t>(-1);
+
+  double copy_ms{0};
+  double sort_ms{0};
+  double scan_ms{0};
+
+  size_t edges_examined{0};
+  size_t edges_accepted{0};
+
+  // position in weight order of the edge that completed the last MST
+  size_t early_exit_index{kNoEarlyExit};
+
+  // nodes whose representative Join rewrote (parent links for UnionFind)
+  size_t nodes_relabelled{0};
+
+  // finds by number of links followed
+  std::array<size_t, kFindBuckets> find_path_lengths{};
+
+  auto Reset() -> void { *this = MstStats{}; }
+
+  auto Add(const MstStats& other) -> void {
+    copy_ms += other.copy_ms;
+    sort_ms += other.sort_ms;
+    scan_ms += other.scan_ms;
+    edges_examined += other.edges_examined;
+    edges_accepted += other.edges_accepted;
+    if (other.early_exit_index != kNoEarlyExit) {
+      early_exit_index = other.early_exit_index;
+    }
+    nodes_relabelled += other.nodes_relabelled;
+    for (size_t i = 0; i < kFindBuckets; ++i) {
+      find_path_lengths[i] += other.find_path_lengths[i];
+    }
+  }
+
+  auto RecordFind(const size_t length) -> void {
+    ++find_path_lengths[length < kFindBuckets ? length : kFindBuckets - 1];
+  }
+};
+
+/**
+ * @brief Counters of the calling thread
+ */
+inline auto mst_stats() -> MstStats& {
+  thread_local MstStats stats{};
+  return stats;
+}
+
+/**
+ * @brief Writes 'stats' as one JSON object
+ */
+inline auto write_json(std::ostream& os, const MstStats& stats)
+  -> std::ostream& {
+  os << "{\"instrumented\": " << (kMstInstrumented ? "true" : "false")
+     << ", \"copy_ms\": " << stats.copy_ms
+     << ", \"sort_ms\": " << stats.sort_ms
+     << ", \"scan_ms\": " << stats.scan_ms
+     << ", \"edges_examined\": " << stats.edges_examined
+     << ", \"edges_accepted\": " << stats.edges_accepted
+     << ", \"early_exit_index\": ";
+  if (stats.early_exit_index == MstStats::kNoEarlyExit) {
+    os << "null";
+  } else {
+    os << stats.early_exit_index;
+  }
+  os << ", \"nodes_relabelled\": " << stats.nodes_relabelled
+     << ", \"find_path_lengths\": [";
+  for (size_t i = 0; i < stats.find_path_lengths.size(); ++i) {
+    os << (i ? ", " : "") << stats.find_path_lengths[i];
+  }
+  return os << "]}";
+}
+
+namespace detail {
+  [[nodiscard]] inline auto ms_since(
+    const std::chrono::steady_clock::time_point start
+  ) -> double {
+    return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start
+    )
+      .count();
+  }
+
+  /**
+   * @brief Counts the links one find follows, recorded on destruction
+   */
+  class FindPathRecorder final {
+  public:
+
+    FindPathRecorder() = default;
+    FindPathRecorder(const FindPathRecorder&) = delete;
+    auto operator=(const FindPathRecorder&) -> FindPathRecorder& = delete;
+
+    ~FindPathRecorder() { mst_stats().RecordFind(length); }
+
+    auto Step() -> void { ++length; }
+
+  private:
+
+    size_t length{0};
+  };
+}
+
+#ifdef MST_INSTRUMENT
+#define MST_STATS_PHASE_BEGIN(phase) \
+  const auto mst_stats_##phase##_start = std::chrono::steady_clock::now()
+#define MST_STATS_PHASE_END(phase) \
+  (mst_stats().phase##_ms += detail::ms_since(mst_stats_##phase##_start))
+#define MST_STATS_ADD(counter, amount) (mst_stats().counter += (amount))
+#define MST_STATS_SET(field, value) (mst_stats().field = (value))
+#define MST_STATS_FIND_PATH(path) detail::FindPathRecorder path{}
+#define MST_STATS_FIND_STEP(path) (path.Step())
+#else
+#define MST_STATS_PHASE_BEGIN(phase)
+#define MST_STATS_PHASE_END(phase)
+#define MST_STATS_ADD(counter, amount)
+#define MST_STATS_SET(field, value)
+#define MST_STATS_FIND_PATH(path)
+#define MST_STATS_FIND_STEP(path)
+#endif
+
+#endif
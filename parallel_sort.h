@@ -0,0 +1,118 @@
+/*!
+  \brief  Parallel sample sort on a ThreadPool
+
+Implements:
+  parallel_sort( items, pool, less )               buckets sorted by std::sort
+  parallel_sort( items, pool, less, sort_bucket )  custom bucket sort
+
+Rationale:
+  every thread classifies its contiguous chunk against P - 1 splitters drawn
+  from a regular sample, buckets are filled chunk by chunk (so each bucket
+  keeps the input order of its items), then sorted and copied back in
+  parallel. 'less' must be a strict total order for balanced buckets - with
+  many equal keys, break ties on the position.
+*/
+
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+#include <algorithm>
+#include <vector>
+#include "thread_pool.h"
+
+/**
+ * @brief Items per thread below which a single std::sort is faster
+ */
+inline constexpr size_t kParallelSortGrain = size_t{1} << 14;
+
+/**
+ * @brief Sorts 'items' by 'less' on the pool, sort_bucket(std::vector<T>&)
+ * sorts one bucket and is called with the bucket's items in input order
+ */
+template<typename T, typename Less, typename BucketSort>
+auto parallel_sort(
+  std::vector<T>& items,
+  ThreadPool& pool,
+  Less less,
+  BucketSort sort_bucket
+) -> void {
+  const size_t threads = pool.Size();
+  const size_t n = items.size();
+
+  if (threads == 1 || n < threads * kParallelSortGrain) {
+    sort_bucket(items);
+    return;
+  }
+
+  // regular sample, oversampled so buckets stay within a few % of n / P
+  const size_t oversample = 32;
+  std::vector<T> sample{};
+  sample.reserve(threads * oversample);
+  for (size_t i = 0; i < threads * oversample; ++i) {
+    sample.push_back(items[(2 * i + 1) * n / (2 * threads * oversample)]);
+  }
+  std::sort(sample.begin(), sample.end(), less);
+
+  std::vector<T> splitters{};
+  for (size_t b = 1; b < threads; ++b) {
+    splitters.push_back(sample[b * oversample]);
+  }
+
+  // bucket of every item, and how many each chunk sends to each bucket
+  std::vector<unsigned> bucket_of(n);
+  std::vector<size_t> counts(threads * threads, 0);
+  pool.ParallelFor(n, [&](size_t begin, size_t end, size_t chunk) {
+    size_t* chunk_counts = &counts[chunk * threads];
+    for (size_t i = begin; i < end; ++i) {
+      const size_t b = static_cast<size_t>(
+        std::upper_bound(splitters.begin(), splitters.end(), items[i], less)
+        - splitters.begin()
+      );
+      bucket_of[i] = static_cast<unsigned>(b);
+      ++chunk_counts[b];
+    }
+  });
+
+  // offsets[chunk][bucket] inside the bucket, chunk order = input order
+  std::vector<size_t> offsets(threads * threads, 0);
+  std::vector<size_t> bucket_sizes(threads, 0);
+  for (size_t b = 0; b < threads; ++b) {
+    for (size_t chunk = 0; chunk < threads; ++chunk) {
+      offsets[chunk * threads + b] = bucket_sizes[b];
+      bucket_sizes[b] += counts[chunk * threads + b];
+    }
+  }
+
+  std::vector<std::vector<T>> buckets(threads);
+  pool.Run(threads, [&](size_t b) { buckets[b].resize(bucket_sizes[b]); });
+
+  pool.ParallelFor(n, [&](size_t begin, size_t end, size_t chunk) {
+    size_t* next = &offsets[chunk * threads];
+    for (size_t i = begin; i < end; ++i) {
+      const unsigned b = bucket_of[i];
+      buckets[b][next[b]++] = items[i];
+    }
+  });
+
+  std::vector<size_t> starts(threads, 0);
+  for (size_t b = 1; b < threads; ++b) {
+    starts[b] = starts[b - 1] + bucket_sizes[b - 1];
+  }
+
+  pool.Run(threads, [&](size_t b) {
+    sort_bucket(buckets[b]);
+    std::copy(buckets[b].begin(), buckets[b].end(), items.begin() + starts[b]);
+  });
+}
+
+/**
+ * @brief Sorts 'items' by 'less' on the pool
+ */
+template<typename T, typename Less>
+auto parallel_sort(std::vector<T>& items, ThreadPool& pool, Less less)
+  -> void {
+  parallel_sort(items, pool, less, [&](std::vector<T>& bucket) {
+    std::sort(bucket.begin(), bucket.end(), less);
+  });
+}
+
+#endif
@@ -0,0 +1,380 @@
+/*!
+  \brief  Prim's MST for dense graphs
+
+Implements:
+  prim( graph )                  indexed d-ary heap with decrease-key,
+                                 O(E log_d V)
+  dense_prim( graph )            array of best edges scanned for the minimum,
+                                 O(V^2 + E), for (near) complete graphs
+  minimum_spanning_tree( graph ) picks dense_prim, prim or kruskal from the
+                                 edge count and density E / V
+
+Rationale:
+  kruskal() sorts all E edges, prim() only keeps one candidate per vertex
+  in a heap, so it wins once E / V is large. Both solvers order edges by
+  (weight, position in GetEdges()) like every other engine, which makes the
+  forest unique; the result is sorted in that order, so it equals kruskal()'s
+  vector edge for edge. GetOutEdges() does not tell where an edge sits in
+  GetEdges(), so the adjacency is rebuilt once as an array of arcs carrying
+  their rank (one counting pass, like UndirectedGraph's incidence array).
+  Disconnected graphs give a spanning forest, one tree per component.
+*/
+
+#ifndef PRIM_H
+#define PRIM_H
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "kruskal.h"
+#include "radix_sort.h"
+
+namespace detail {
+  /**
+   * @class IndexedDaryHeap
+   * @brief Min-heap (by Less) of the IDs 0..capacity-1, each with its own
+   * key, with decrease-key through a position table
+   */
+  template<typename Key, size_t D = 4, typename Less = std::less<Key>>
+  class IndexedDaryHeap final {
+  public:
+
+    static_assert(D >= 2, "a heap needs at least two children per node");
+
+    explicit IndexedDaryHeap(const size_t capacity):
+        heap(), position(capacity, kAbsent), keys(capacity) {
+      heap.reserve(capacity);
+    }
+
+    [[nodiscard]] auto Empty() const -> bool { return heap.empty(); }
+
+    [[nodiscard]] auto Contains(const size_t id) const -> bool {
+      return position[id] != kAbsent;
+    }
+
+    [[nodiscard]] auto KeyOf(const size_t id) const -> const Key& {
+      return keys[id];
+    }
+
+    /**
+     * @brief Inserts 'id', or lowers its key if 'key' is smaller
+     */
+    auto PushOrDecrease(const size_t id, const Key& key) -> void {
+      if (!Contains(id)) {
+        keys[id] = key;
+        position[id] = heap.size();
+        heap.push_back(id);
+        SiftUp(position[id]);
+      } else if (less(key, keys[id])) {
+        keys[id] = key;
+        SiftUp(position[id]);
+      }
+    }
+
+    /**
+     * @brief Removes and returns the ID with the smallest key
+     */
+    auto Pop() -> size_t {
+      const size_t top = heap.front();
+      position[top] = kAbsent;
+
+      const size_t last = heap.back();
+      heap.pop_back();
+      if (!heap.empty()) {
+        heap.front() = last;
+        position[last] = 0;
+        SiftDown(0);
+      }
+      return top;
+    }
+
+  private:
+
+    static constexpr size_t kAbsent = std::numeric_limits<size_t>::max();
+
+    auto SiftUp(size_t slot) -> void {
+      const size_t id = heap[slot];
+      while (slot > 0) {
+        const size_t parent = (slot - 1) / D;
+        if (!less(keys[id], keys[heap[parent]])) {
+          break;
+        }
+        Place(slot, heap[parent]);
+        slot = parent;
+      }
+      Place(slot, id);
+    }
+
+    auto SiftDown(size_t slot) -> void {
+      const size_t id = heap[slot];
+      for (;;) {
+        const size_t first = slot * D + 1;
+        if (first >= heap.size()) {
+          break;
+        }
+
+        size_t best = first;
+        const size_t end = std::min(first + D, heap.size());
+        for (size_t child = first + 1; child < end; ++child) {
+          if (less(keys[heap[child]], keys[heap[best]])) {
+            best = child;
+          }
+        }
+        if (!less(keys[heap[best]], keys[id])) {
+          break;
+        }
+        Place(slot, heap[best]);
+        slot = best;
+      }
+      Place(slot, id);
+    }
+
+    auto Place(const size_t slot, const size_t id) -> void {
+      heap[slot] = id;
+      position[id] = slot;
+    }
+
+    // IDs in heap order
+    std::vector<size_t> heap;
+
+    // slot of every ID in 'heap', kAbsent when not queued
+    std::vector<size_t> position;
+
+    // current key of every queued ID
+    std::vector<Key> keys;
+
+    Less less{};
+  };
+
+  /**
+   * @brief by_key_then_index as a function object
+   */
+  struct ByKeyThenIndex {
+    template<typename Key, typename Index>
+    auto operator()(
+      const KeyedIndex<Key, Index>& a,
+      const KeyedIndex<Key, Index>& b
+    ) const -> bool {
+      return by_key_then_index(a, b);
+    }
+  };
+
+  /**
+   * @brief One side of an edge: where it leads and its rank in the total
+   * order (weight key, position in GetEdges())
+   */
+  template<typename Rank>
+  struct Arc {
+    Rank rank;
+    size_t other;
+  };
+
+  /**
+   * @brief Arcs of every vertex: the edges at v are
+   * arcs[offsets[v] .. offsets[v + 1]), self loops are left out. Each arc
+   * carries its key, so relaxing a vertex reads one contiguous run instead
+   * of gathering edges from all over GetEdges()
+   */
+  template<typename Rank>
+  struct Incidence {
+    std::vector<size_t> offsets;
+    std::vector<Arc<Rank>> arcs;
+  };
+
+  template<typename Rank, typename Edges>
+  [[nodiscard]] auto build_incidence(const Edges& edges, const size_t size)
+    -> Incidence<Rank> {
+    std::vector<size_t> next(size + 1, 0);
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (edges[i].ID1() != edges[i].ID2()) {
+        ++next[edges[i].ID1() + 1];
+        ++next[edges[i].ID2() + 1];
+      }
+    }
+    for (size_t v = 0; v < size; ++v) {
+      next[v + 1] += next[v];
+    }
+
+    Incidence<Rank> incidence{next, std::vector<Arc<Rank>>(next[size])};
+    for (size_t i = 0; i < edges.size(); ++i) {
+      const size_t v1 = edges[i].ID1(), v2 = edges[i].ID2();
+      if (v1 != v2) {
+        const Rank rank{sort_key(edges[i]), i};
+        incidence.arcs[next[v1]++] = Arc<Rank>{rank, v2};
+        incidence.arcs[next[v2]++] = Arc<Rank>{rank, v1};
+      }
+    }
+    return incidence;
+  }
+
+  /**
+   * @brief Edges at the given positions in kruskal()'s order
+   */
+  template<typename Edges>
+  [[nodiscard]] auto edges_in_order(
+    const Edges& edges,
+    std::vector<KeyedIndex<SortKeyOf<typename Edges::value_type>>>& picked
+  ) -> std::vector<typename Edges::value_type> {
+    std::sort(picked.begin(), picked.end(), ByKeyThenIndex{});
+
+    std::vector<typename Edges::value_type> mst{};
+    mst.reserve(picked.size());
+    for (const auto& edge: picked) {
+      mst.push_back(edges[edge.index]);
+    }
+    return mst;
+  }
+}
+
+/**
+ * @brief Prim's MST with an indexed D-ary heap of the lightest known edge
+ * into every fringe vertex (bench_prim: D = 2 ahead of 4 on large dense
+ * graphs, where decrease-keys are rare and pops dominate)
+ */
+template<size_t D = 2, typename GraphType>
+auto prim(const GraphType& graph) -> std::vector<typename GraphType::Edge> {
+  using Edge = typename GraphType::Edge;
+  using Rank = KeyedIndex<detail::SortKeyOf<Edge>>;
+
+  const auto edges = detail::random_access_edges(graph);
+  const size_t size = graph.Size();
+  const detail::Incidence<Rank> adjacency =
+    detail::build_incidence<Rank>(edges, size);
+
+  std::vector<bool> in_tree(size, false);
+  detail::IndexedDaryHeap<Rank, D, detail::ByKeyThenIndex> fringe{size};
+
+  std::vector<Rank> picked{};
+  picked.reserve(size > 0 ? size - 1 : 0);
+
+  // one tree per component, grown from its lowest vertex
+  for (size_t start = 0; start < size; ++start) {
+    if (in_tree[start]) {
+      continue;
+    }
+
+    size_t v = start;
+    for (;;) {
+      in_tree[v] = true;
+      const size_t end = adjacency.offsets[v + 1];
+      for (size_t i = adjacency.offsets[v]; i < end; ++i) {
+        const detail::Arc<Rank>& arc = adjacency.arcs[i];
+        if (!in_tree[arc.other]) {
+          fringe.PushOrDecrease(arc.other, arc.rank);
+        }
+      }
+
+      if (fringe.Empty()) {
+        break;
+      }
+      v = fringe.Pop();
+      picked.push_back(fringe.KeyOf(v));
+    }
+  }
+
+  return detail::edges_in_order(edges, picked);
+}
+
+/**
+ * @brief Prim's MST keeping the lightest known edge into every vertex in a
+ * flat array, the next vertex is found by scanning it: O(V^2) with no heap
+ * overhead, the better choice for (near) complete graphs
+ */
+template<typename GraphType>
+auto dense_prim(const GraphType& graph)
+  -> std::vector<typename GraphType::Edge> {
+  using Edge = typename GraphType::Edge;
+  using Rank = KeyedIndex<detail::SortKeyOf<Edge>>;
+
+  constexpr size_t none = std::numeric_limits<size_t>::max();
+
+  const auto edges = detail::random_access_edges(graph);
+  const size_t size = graph.Size();
+  const detail::Incidence<Rank> adjacency =
+    detail::build_incidence<Rank>(edges, size);
+
+  const detail::ByKeyThenIndex lighter{};
+
+  // lightest known edge into every vertex, index 'none' until one is seen;
+  // tree vertices are swapped out of 'fringe' so the scan only covers the
+  // rest
+  std::vector<Rank> best(size, Rank{{}, none});
+  std::vector<size_t> fringe(size);
+  std::vector<size_t> slot(size);
+  for (size_t v = 0; v < size; ++v) {
+    fringe[v] = v;
+    slot[v] = v;
+  }
+
+  const auto take = [&](const size_t v) {
+    const size_t last = fringe.back();
+    fringe[slot[v]] = last;
+    slot[last] = slot[v];
+    fringe.pop_back();
+    slot[v] = none;
+  };
+
+  std::vector<Rank> picked{};
+  picked.reserve(size > 0 ? size - 1 : 0);
+
+  while (!fringe.empty()) {
+    // lightest edge into the tree, any fringe vertex starts a new component
+    size_t v = none;
+    for (const size_t u: fringe) {
+      if (best[u].index != none && (v == none || lighter(best[u], best[v]))) {
+        v = u;
+      }
+    }
+    if (v == none) {
+      v = fringe.back();
+    } else {
+      picked.push_back(best[v]);
+    }
+    take(v);
+
+    const size_t end = adjacency.offsets[v + 1];
+    for (size_t i = adjacency.offsets[v]; i < end; ++i) {
+      const detail::Arc<Rank>& arc = adjacency.arcs[i];
+      if (slot[arc.other] != none
+          && (best[arc.other].index == none
+              || lighter(arc.rank, best[arc.other]))) {
+        best[arc.other] = arc.rank;
+      }
+    }
+  }
+
+  return detail::edges_in_order(edges, picked);
+}
+
+/**
+ * @brief E / V from which prim() beats kruskal(), and the fraction of all
+ * vertex pairs from which dense_prim() is used instead of prim(). Measured
+ * with bench_prim at V = 4096 and 8192: prim() is ahead from E / V = 256
+ * to 512, dense_prim() only draws level with it on (near) complete graphs.
+ * Below about 1M edges everything fits in cache and kruskal() wins at any
+ * density
+ */
+inline constexpr double kPrimDensity = 256;
+inline constexpr double kDensePrimFill = 0.9;
+inline constexpr double kPrimMinEdges = 1 << 20;
+
+/**
+ * @brief MST by the engine expected to be fastest for the graph's density
+ */
+template<typename GraphType>
+auto minimum_spanning_tree(const GraphType& graph)
+  -> std::vector<typename GraphType::Edge> {
+  const double V = static_cast<double>(graph.Size());
+  const double E = static_cast<double>(graph.GetEdges().size());
+
+  if (E < kPrimMinEdges || E < kPrimDensity * V) {
+    return kruskal(graph);
+  }
+  if (E >= kDensePrimFill * V * (V - 1) / 2) {
+    return dense_prim(graph);
+  }
+  return prim(graph);
+}
+
+#endif
@@ -0,0 +1,194 @@
+/*!
+  \brief  Stable LSD radix sort for (key, index) pairs with arithmetic keys
+
+Implements:
+  to_radix_key( value )   order-preserving map of int/float to unsigned
+  radix_sort( items )     stable sort of KeyedIndex by key
+  counting_sort_order( count, buckets, bucket_of )
+                          positions 0..count-1 stably ordered by a bucket
+                          number below 'buckets' (small integer keys)
+
+Rationale:
+  sorting a compact (key, index) array moves far less memory than sorting
+  whole objects. Keys are rebased on the minimum key, so only the bytes that
+  actually differ are sorted - small integer ranges (weights 1..10) take a
+  single counting pass.
+*/
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace detail {
+  template<typename T, typename = void>
+  struct RadixKeyOf;
+
+  template<typename T>
+  struct RadixKeyOf<T, std::enable_if_t<std::is_integral_v<T>>> {
+    using type = std::make_unsigned_t<std::conditional_t<
+      (sizeof(T) < sizeof(uint32_t)),
+      std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>,
+      T>>;
+  };
+
+  template<>
+  struct RadixKeyOf<float> {
+    using type = uint32_t;
+  };
+
+  template<>
+  struct RadixKeyOf<double> {
+    using type = uint64_t;
+  };
+}
+
+/**
+ * @brief Unsigned key type sorting in the same order as T
+ */
+template<typename T>
+using RadixKey = typename detail::RadixKeyOf<T>::type;
+
+/**
+ * @brief Maps an arithmetic value to an unsigned key with the same ordering
+ *
+ * Floats: positive values get the sign bit set, negative values are fully
+ * inverted, so -0.0 sorts just below +0.0 and NaNs land at either end
+ */
+template<typename T>
+[[nodiscard]] auto to_radix_key(const T value) -> RadixKey<T> {
+  using Key = RadixKey<T>;
+
+  if constexpr (std::is_floating_point_v<T>) {
+    static_assert(sizeof(T) == sizeof(Key), "unsupported floating point type");
+    Key bits{};
+    std::memcpy(&bits, &value, sizeof(bits));
+    constexpr Key sign = Key{1} << (sizeof(Key) * 8 - 1);
+    return (bits & sign) ? ~bits : (bits | sign);
+  } else if constexpr (std::is_signed_v<T>) {
+    constexpr Key sign = Key{1} << (sizeof(Key) * 8 - 1);
+    return static_cast<Key>(value) ^ sign;
+  } else {
+    return static_cast<Key>(value);
+  }
+}
+
+/**
+ * @brief Sort record, 'index' refers back to the owner of the key (32-bit
+ * indices halve the record for 32-bit keys)
+ */
+template<typename Key, typename Index = size_t>
+struct KeyedIndex {
+  Key key;
+  Index index;
+};
+
+/**
+ * @brief Key ranges up to this size are sorted with one counting pass
+ */
+inline constexpr size_t kCountingSortRange = size_t{1} << 16;
+
+/**
+ * @brief Stable sort of 'items' by key (equal keys keep their relative order)
+ */
+template<typename Key, typename Index>
+auto radix_sort(std::vector<KeyedIndex<Key, Index>>& items) -> void {
+  using Item = KeyedIndex<Key, Index>;
+  static_assert(std::is_unsigned_v<Key>, "radix keys must be unsigned");
+
+  if (items.size() < 2) {
+    return;
+  }
+
+  const auto [min_it, max_it] = std::minmax_element(
+    items.begin(),
+    items.end(),
+    [](const Item& a, const Item& b) {
+      return a.key < b.key;
+    }
+  );
+  const Key min = min_it->key;
+  const Key range = max_it->key - min;
+
+  if (range == 0) {
+    return;
+  }
+
+  std::vector<Item> buffer(items.size());
+
+  // small range: one counting pass over the rebased key
+  if (range < kCountingSortRange && range <= items.size()) {
+    std::vector<size_t> offsets(static_cast<size_t>(range) + 2, 0);
+    for (const Item& item: items) {
+      ++offsets[static_cast<size_t>(item.key - min) + 1];
+    }
+    for (size_t i = 1; i < offsets.size(); ++i) {
+      offsets[i] += offsets[i - 1];
+    }
+    for (const Item& item: items) {
+      buffer[offsets[static_cast<size_t>(item.key - min)]++] = item;
+    }
+    items.swap(buffer);
+    return;
+  }
+
+  // LSD over the bytes of the rebased key that are not always zero
+  size_t passes = 0;
+  for (Key rest = range; rest != 0; rest >>= 8) {
+    ++passes;
+  }
+
+  for (size_t pass = 0; pass < passes; ++pass) {
+    const size_t shift = pass * 8;
+    size_t offsets[257]{};
+
+    for (const Item& item: items) {
+      ++offsets[((item.key - min) >> shift & 0xFF) + 1];
+    }
+
+    // every key shares this byte, nothing to reorder
+    if (std::find(std::begin(offsets), std::end(offsets), items.size())
+        != std::end(offsets)) {
+      continue;
+    }
+
+    for (size_t i = 1; i < 257; ++i) {
+      offsets[i] += offsets[i - 1];
+    }
+    for (const Item& item: items) {
+      buffer[offsets[(item.key - min) >> shift & 0xFF]++] = item;
+    }
+    items.swap(buffer);
+  }
+}
+
+/**
+ * @brief Positions 0..count-1 stably sorted by bucket_of(position), which
+ * must be below 'buckets' - a single counting pass, no keys are stored
+ */
+template<typename Index, typename BucketOf>
+auto counting_sort_order(
+  const size_t count,
+  const size_t buckets,
+  BucketOf&& bucket_of
+) -> std::vector<Index> {
+  std::vector<Index> offsets(buckets + 1, 0);
+  for (size_t i = 0; i < count; ++i) {
+    ++offsets[bucket_of(i) + 1];
+  }
+  for (size_t b = 1; b <= buckets; ++b) {
+    offsets[b] += offsets[b - 1];
+  }
+
+  std::vector<Index> order(count);
+  for (size_t i = 0; i < count; ++i) {
+    order[offsets[bucket_of(i)]++] = static_cast<Index>(i);
+  }
+  return order;
+}
+
+#endif
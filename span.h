@@ -0,0 +1,74 @@
+/*!
+  \brief  Non-owning view over a contiguous array (C++17 stand-in for
+  std::span)
+
+Implements:
+  ctor (pointer, size)
+  ctor (contiguous container)
+  begin / end / size / empty / data / operator[]
+*/
+
+#ifndef SPAN_H
+#define SPAN_H
+#include <cstdlib>
+#include <type_traits>
+
+/**
+ * @class Span
+ * @brief Pointer + length view over contiguous elements, never owns them
+ */
+template<typename T>
+class Span final {
+public:
+
+  using value_type = std::remove_cv_t<T>;
+  using iterator = T*;
+
+  /**
+   * @brief Empty view
+   */
+  constexpr Span() = default;
+
+  /**
+   * @brief View over 'size' elements starting at 'data'
+   */
+  constexpr Span(T* data, size_t size): pointer{data}, length{size} {}
+
+  /**
+   * @brief View over any contiguous container (std::vector, std::array...)
+   */
+  template<
+    typename Container,
+    typename = std::enable_if_t<!std::is_same_v<std::decay_t<Container>, Span>>>
+  constexpr Span(Container& container):
+      pointer{container.data()}, length{container.size()} {}
+
+  [[nodiscard]] constexpr auto begin() const -> T* { return pointer; }
+
+  [[nodiscard]] constexpr auto end() const -> T* { return pointer + length; }
+
+  [[nodiscard]] constexpr auto data() const -> T* { return pointer; }
+
+  [[nodiscard]] constexpr auto size() const -> size_t { return length; }
+
+  [[nodiscard]] constexpr auto empty() const -> bool { return length == 0; }
+
+  [[nodiscard]] constexpr auto operator[](size_t i) const -> T& {
+    return pointer[i];
+  }
+
+  /**
+   * @brief Sub-view of 'count' elements starting at 'offset'
+   */
+  [[nodiscard]] constexpr auto subspan(size_t offset, size_t count) const
+    -> Span {
+    return Span{pointer + offset, count};
+  }
+
+private:
+
+  T* pointer{nullptr};
+  size_t length{0};
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*!
+  \brief  Minimum spanning forest, one component per task
+
+Implements:
+  SpanningForest                     trees grouped by component, component
+                                     label of every vertex
+  minimum_spanning_forest( graph, pool )
+  minimum_spanning_forest( graph, threads )
+
+Rationale:
+  kruskal() stops once it has V - 1 edges, which never happens on a
+  disconnected graph, so it scans every edge. Here one union-find pass over
+  the edges labels the components first; the edges are then bucketed by
+  component (stable, so input order survives) and every component is sorted
+  and scanned on its own, as a pool task, with a union-find of its own size
+  and its own early exit at n_c - 1 edges. Components are numbered in order
+  of their lowest vertex and their tree has exactly n_c - 1 edges, so every
+  tree's slot in the output is known before any task runs. Each tree is the
+  one kruskal() picks for that component, in the same (weight, input
+  position) order.
+*/
+
+#ifndef SPANNING_FOREST_H
+#define SPANNING_FOREST_H
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "kruskal.h"
+#include "span.h"
+#include "thread_pool.h"
+#include "union_find.h"
+
+/**
+ * @brief Minimum spanning forest grouped by component
+ */
+template<typename Edge>
+struct SpanningForest {
+  // component of every vertex, numbered in order of their lowest vertex
+  std::vector<size_t> component;
+
+  // tree of component c is edges[offsets[c] .. offsets[c + 1])
+  std::vector<size_t> offsets;
+  std::vector<Edge> edges;
+
+  [[nodiscard]] auto Components() const -> size_t {
+    return offsets.size() - 1;
+  }
+
+  /**
+   * @brief Tree of component c, in kruskal() order
+   */
+  [[nodiscard]] auto Tree(const size_t c) const -> Span<const Edge> {
+    return Span<const Edge>{
+      edges.data() + offsets[c], offsets[c + 1] - offsets[c]
+    };
+  }
+};
+
+namespace detail {
+  /**
+   * @brief Edges of one component, edges[positions[i]] seen as element i
+   */
+  template<typename Edges>
+  class GatheredEdges final {
+  public:
+
+    using value_type = typename Edges::value_type;
+
+    GatheredEdges(const Edges& edges, const Span<const size_t> positions):
+        edges{edges}, positions{positions} {}
+
+    [[nodiscard]] auto operator[](const size_t i) const -> const value_type& {
+      return edges[positions[i]];
+    }
+
+    [[nodiscard]] auto size() const -> size_t { return positions.size(); }
+
+  private:
+
+    const Edges& edges;
+    Span<const size_t> positions;
+  };
+}
+
+/**
+ * @brief Minimum spanning forest, components solved in parallel on 'pool'
+ * with 'Sets' as the per-component union-find
+ */
+template<typename Sets = UnionFind, typename GraphType>
+auto minimum_spanning_forest(const GraphType& graph, ThreadPool& pool)
+  -> SpanningForest<typename GraphType::Edge> {
+  using Edge = typename GraphType::Edge;
+  using Policy = KruskalPolicy<Edge, Sets>;
+
+  const size_t size = graph.Size();
+  const auto edges = detail::random_access_edges(graph);
+
+  // label components: one union-find pass over the edges, then dense labels
+  // and the vertex's index within its component
+  UnionFind connectivity{size};
+  for (size_t v = 0; v < size; ++v) {
+    connectivity.Make();
+  }
+  for (size_t i = 0; i < edges.size(); ++i) {
+    connectivity.Join(edges[i].ID1(), edges[i].ID2());
+  }
+
+  constexpr size_t unlabelled = static_cast<size_t>(-1);
+  SpanningForest<Edge> forest{std::vector<size_t>(size), {0}, {}};
+  std::vector<size_t> label_of(size, unlabelled);
+  std::vector<size_t> local(size);
+  std::vector<size_t> vertices{};
+  for (size_t v = 0; v < size; ++v) {
+    const size_t root = connectivity.GetRepresentative(v);
+    if (label_of[root] == unlabelled) {
+      label_of[root] = vertices.size();
+      vertices.push_back(0);
+    }
+    forest.component[v] = label_of[root];
+    local[v] = vertices[label_of[root]]++;
+  }
+
+  const size_t components = vertices.size();
+  forest.offsets.reserve(components + 1);
+  for (size_t c = 0; c < components; ++c) {
+    forest.offsets.push_back(forest.offsets.back() + vertices[c] - 1);
+  }
+  forest.edges.resize(forest.offsets.back());
+
+  // bucket edge positions by component, self loops can never be picked
+  std::vector<size_t> start(components + 1, 0);
+  for (size_t i = 0; i < edges.size(); ++i) {
+    if (edges[i].ID1() != edges[i].ID2()) {
+      ++start[forest.component[edges[i].ID1()] + 1];
+    }
+  }
+  for (size_t c = 0; c < components; ++c) {
+    start[c + 1] += start[c];
+  }
+  std::vector<size_t> positions(start[components]);
+  std::vector<size_t> fill(start.begin(), start.end() - 1);
+  for (size_t i = 0; i < edges.size(); ++i) {
+    if (edges[i].ID1() != edges[i].ID2()) {
+      positions[fill[forest.component[edges[i].ID1()]]++] = i;
+    }
+  }
+
+  // single vertices have nothing to solve, the rest go largest first so a
+  // big component does not start last
+  std::vector<size_t> tasks{};
+  for (size_t c = 0; c < components; ++c) {
+    if (vertices[c] > 1) {
+      tasks.push_back(c);
+    }
+  }
+  std::stable_sort(tasks.begin(), tasks.end(), [&](size_t a, size_t b) {
+    return start[a + 1] - start[a] > start[b + 1] - start[b];
+  });
+
+  pool.Run(tasks.size(), [&](const size_t task) {
+    const size_t c = tasks[task];
+    const Span<const size_t> members{
+      positions.data() + start[c], start[c + 1] - start[c]
+    };
+    const detail::GatheredEdges<std::decay_t<decltype(edges)>> component{
+      edges, members
+    };
+
+    Sets set{vertices[c]};
+    for (size_t v = 0; v < vertices[c]; ++v) {
+      set.Make();
+    }
+
+    Edge* tree = forest.edges.data() + forest.offsets[c];
+    detail::for_each_by_key<Policy>(
+      component,
+      detail::tree_scan(
+        set,
+        vertices[c] - 1,
+        [&](const Edge& edge) {
+          return std::pair<size_t, size_t>{
+            local[edge.ID1()], local[edge.ID2()]
+          };
+        },
+        [&](const Edge& edge) { *tree++ = edge; }
+      )
+    );
+  });
+
+  return forest;
+}
+
+/**
+ * @brief Minimum spanning forest on 'threads' threads (0 means all cores)
+ */
+template<typename Sets = UnionFind, typename GraphType>
+auto minimum_spanning_forest(const GraphType& graph, const size_t threads = 0)
+  -> SpanningForest<typename GraphType::Edge> {
+  ThreadPool pool{threads};
+  return minimum_spanning_forest<Sets>(graph, pool);
+}
+
+#endif
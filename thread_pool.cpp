@@ -0,0 +1,127 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(const size_t threads) {
+  const size_t total =
+    threads != 0 ? threads
+                 : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+  workers.reserve(total - 1);
+  for (size_t i = 1; i < total; ++i) {
+    workers.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    stopping = true;
+  }
+  job_ready.notify_all();
+
+  for (std::thread& worker: workers) {
+    worker.join();
+  }
+}
+
+auto ThreadPool::Size() const -> size_t { return workers.size() + 1; }
+
+auto ThreadPool::Run(
+  const size_t count,
+  const std::function<void(size_t)>& new_task
+) -> void {
+  if (count == 0) {
+    return;
+  }
+
+  // nothing to share, skip the hand-off
+  if (workers.empty() || count == 1) {
+    for (size_t i = 0; i < count; ++i) {
+      new_task(i);
+    }
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    // a worker that woke up late for the previous job may still be leaving
+    job_done.wait(lock, [this] { return active == 0; });
+
+    task = &new_task;
+    task_count = count;
+    next_task.store(0);
+    remaining.store(count);
+    ++generation;
+  }
+  job_ready.notify_all();
+
+  Drain();
+
+  std::unique_lock<std::mutex> lock{mutex};
+  job_done.wait(lock, [this] {
+    return remaining.load() == 0 && active == 0;
+  });
+  task = nullptr;
+
+#ifdef MST_INSTRUMENT
+  mst_stats().Add(job_stats);
+  job_stats.Reset();
+#endif
+
+  // no thread touches the job any more, the exception can leave
+  const std::exception_ptr error = std::exchange(failure, nullptr);
+  lock.unlock();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+auto ThreadPool::Drain() -> void {
+  for (size_t i = next_task.fetch_add(1); i < task_count;
+       i = next_task.fetch_add(1)) {
+    try {
+      (*task)(i);
+    } catch (...) {
+      // must not unwind out of a worker, or out of Run while workers still
+      // call through 'task'
+      std::lock_guard<std::mutex> lock{mutex};
+      if (!failure) {
+        failure = std::current_exception();
+      }
+    }
+
+    if (remaining.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> lock{mutex};
+      job_done.notify_all();
+    }
+  }
+}
+
+auto ThreadPool::WorkerLoop() -> void {
+  size_t seen = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{mutex};
+      job_ready.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping) {
+        return;
+      }
+      seen = generation;
+      ++active;
+    }
+
+    Drain();
+
+    std::lock_guard<std::mutex> lock{mutex};
+#ifdef MST_INSTRUMENT
+    // handed to the thread that called Run
+    job_stats.Add(mst_stats());
+    mst_stats().Reset();
+#endif
+    if (--active == 0) {
+      job_done.notify_all();
+    }
+  }
+}
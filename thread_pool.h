@@ -0,0 +1,119 @@
+/*!
+  \brief  Fixed-size thread pool for data-parallel loops
+
+Implements:
+  ctor (threads)        spawns threads - 1 workers, the caller is the last one
+  Run( count, task )    task(i) for every i in [0, count), blocks until done
+  ParallelFor( n, f )   f(begin, end, chunk) over Size() contiguous chunks
+  Size
+
+Rationale:
+  the MST engines run a handful of short parallel phases per round, so the
+  workers are kept alive between calls instead of spawning threads each time.
+  Tasks are handed out through a shared counter, the calling thread works too.
+  A task that throws does not stop the others: Run waits for every task of
+  the job and then rethrows the first exception on the calling thread.
+  Under MST_INSTRUMENT the workers' MstStats of a job are added to the
+  calling thread's before Run returns.
+*/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "mst_stats.h"
+
+/**
+ * @class ThreadPool
+ * @brief Runs indexed tasks on a fixed set of threads
+ */
+class ThreadPool final {
+public:
+
+  /**
+   * @brief Pool of 'threads' threads in total (0 means hardware concurrency)
+   */
+  explicit ThreadPool(size_t threads = 0);
+
+  /**
+   * @brief Joins every worker
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  /**
+   * @brief Number of threads tasks run on, including the caller
+   */
+  [[nodiscard]] auto Size() const -> size_t;
+
+  /**
+   * @brief Calls task(i) for i in [0, count), returns once all have finished
+   *
+   * If tasks throw, the first exception is rethrown here after the rest of
+   * the job has finished
+   */
+  auto Run(size_t count, const std::function<void(size_t)>& task) -> void;
+
+  /**
+   * @brief Splits [0, n) into Size() contiguous chunks and calls
+   * f(begin, end, chunk) for each of them
+   */
+  template<typename F>
+  auto ParallelFor(const size_t n, F&& f) -> void {
+    const size_t chunks = Size();
+    Run(chunks, [&](const size_t chunk) {
+      f(n * chunk / chunks, n * (chunk + 1) / chunks, chunk);
+    });
+  }
+
+private:
+
+  /**
+   * @brief Pulls tasks of the current job until there are none left
+   */
+  auto Drain() -> void;
+
+  auto WorkerLoop() -> void;
+
+  std::vector<std::thread> workers{};
+
+  std::mutex mutex{};
+
+  // workers wait here for a new job (or shutdown)
+  std::condition_variable job_ready{};
+
+  // the caller waits here for the last task to finish
+  std::condition_variable job_done{};
+
+  // current job, valid while 'remaining' > 0
+  const std::function<void(size_t)>* task{nullptr};
+  size_t task_count{0};
+  std::atomic<size_t> next_task{0};
+  std::atomic<size_t> remaining{0};
+
+  // workers currently inside Drain()
+  size_t active{0};
+
+  // first exception a task of the current job threw
+  std::exception_ptr failure{nullptr};
+
+  // bumped on every Run so sleeping workers can tell jobs apart
+  size_t generation{0};
+
+  bool stopping{false};
+
+  // workers' counters of the current job (MST_INSTRUMENT only)
+  MstStats job_stats{};
+};
+
+#endif
@@ -0,0 +1,257 @@
+/*!
+  \brief  Undirected graph storing every edge once
+
+Same surface as CsrGraph (csr_graph.h):
+  InsertEdge      one call per undirected edge
+  InsertVertex
+  BuildFromEdgeArray
+  GetVertex
+  GetEdges        contiguous span, each edge once, in insertion order
+  GetOutEdges     edges of a vertex oriented away from it (ID1() == vertex)
+  Size
+  Print
+
+Rationale:
+  the driver used to insert (u,v) and (v,u) for every edge, so kruskal()
+  copied and sorted everything twice and half its union-find checks were
+  certain rejects. Here the edge array holds each edge once and kruskal()
+  reads it in place; both endpoints reach the edge through an incidence
+  array of edge indices (built in one counting pass by Finalize(), like
+  CsrGraph's). GetOutEdges yields the edge flipped when the vertex is its
+  ID2, so adjacency walks see the same thing as with doubled edges.
+
+EdgeType requirements (beyond Graph's):
+  ctor EdgeType( id1, id2, weight )   to orient an edge for GetOutEdges
+*/
+
+#ifndef UNDIRECTED_GRAPH_H
+#define UNDIRECTED_GRAPH_H
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "span.h"
+
+template<typename VertexType, typename EdgeType>
+class UndirectedGraph {
+public:
+
+  // the usual type-getters
+  typedef VertexType Vertex;
+  typedef EdgeType Edge;
+
+  /**
+   * @class OutEdges
+   * @brief Edges incident to one vertex, yielded by value with ID1() equal
+   * to that vertex
+   */
+  class OutEdges final {
+  public:
+
+    class Iterator final {
+    public:
+
+      using iterator_category = std::input_iterator_tag;
+      using value_type = EdgeType;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = EdgeType;
+
+      Iterator(const EdgeType* edges, const size_t* position, size_t vertex):
+          edges{edges}, position{position}, vertex{vertex} {}
+
+      auto operator*() const -> EdgeType {
+        const EdgeType& e = edges[*position];
+        return e.ID1() == vertex ? e : EdgeType(e.ID2(), e.ID1(), e.Weight());
+      }
+
+      auto operator++() -> Iterator& {
+        ++position;
+        return *this;
+      }
+
+      auto operator==(const Iterator& rhs) const -> bool {
+        return position == rhs.position;
+      }
+
+      auto operator!=(const Iterator& rhs) const -> bool {
+        return position != rhs.position;
+      }
+
+    private:
+
+      const EdgeType* edges;
+      const size_t* position;
+      size_t vertex;
+    };
+
+    OutEdges(const EdgeType* edges, Span<const size_t> incident, size_t vertex):
+        edges{edges}, incident{incident}, vertex{vertex} {}
+
+    [[nodiscard]] auto begin() const -> Iterator {
+      return Iterator{edges, incident.begin(), vertex};
+    }
+
+    [[nodiscard]] auto end() const -> Iterator {
+      return Iterator{edges, incident.end(), vertex};
+    }
+
+    [[nodiscard]] auto size() const -> size_t { return incident.size(); }
+
+    [[nodiscard]] auto empty() const -> bool { return incident.empty(); }
+
+  private:
+
+    const EdgeType* edges;
+    Span<const size_t> incident;
+    size_t vertex;
+  };
+
+  UndirectedGraph(): vertices(), offsets(1, 0), incident(), edges(), built(0) {}
+
+  /**
+   * @brief Appends an undirected edge, visible after the next Finalize()
+   */
+  auto InsertEdge(const EdgeType& e) -> void {
+    Reserve(std::max(e.ID1(), e.ID2()) + 1);
+    edges.push_back(e);
+  }
+
+  /**
+   * @brief Makes sure the vertex (and every ID below it) exists
+   */
+  auto InsertVertex(const VertexType& v) -> void { Reserve(v.ID() + 1); }
+
+  /**
+   * @brief Appends 'size' undirected edges and builds the incidence arrays
+   */
+  auto BuildFromEdgeArray(const EdgeType* array, const size_t size) -> void {
+    size_t vertex_count = vertices.size();
+    for (size_t i = 0; i < size; ++i) {
+      vertex_count =
+        std::max(vertex_count, std::max(array[i].ID1(), array[i].ID2()) + 1);
+    }
+    Reserve(vertex_count);
+
+    edges.insert(edges.end(), array, array + size);
+    Finalize();
+  }
+
+  /**
+   * @brief Rebuilds the incidence arrays (counting sort by endpoint), edges
+   * are never moved
+   */
+  auto Finalize() -> void {
+    if (IsFinalized()) {
+      return;
+    }
+
+    const size_t vertex_count = vertices.size();
+
+    // a self loop is listed once at its vertex
+    std::vector<size_t> next(vertex_count + 1, 0);
+    for (const EdgeType& e: edges) {
+      ++next[e.ID1() + 1];
+      if (e.ID2() != e.ID1()) {
+        ++next[e.ID2() + 1];
+      }
+    }
+    for (size_t v = 0; v < vertex_count; ++v) {
+      next[v + 1] += next[v];
+    }
+
+    offsets = next;
+    incident.assign(next[vertex_count], 0);
+    for (size_t i = 0; i < edges.size(); ++i) {
+      incident[next[edges[i].ID1()]++] = i;
+      if (edges[i].ID2() != edges[i].ID1()) {
+        incident[next[edges[i].ID2()]++] = i;
+      }
+    }
+
+    built = edges.size();
+  }
+
+  /**
+   * @brief Whether every inserted edge is visible through the getters
+   */
+  [[nodiscard]] auto IsFinalized() const -> bool {
+    return built == edges.size() && offsets.size() == vertices.size() + 1;
+  }
+
+  [[nodiscard]] auto GetVertex(size_t id) const -> const VertexType& {
+    if (id < vertices.size()) {
+      return vertices[id];
+    }
+    throw "cannot find node in the graph";
+  }
+
+  /**
+   * @brief Every edge once, in insertion order
+   */
+  [[nodiscard]] auto GetEdges() const -> Span<const EdgeType> {
+    CheckFinalized();
+    return Span<const EdgeType>{edges};
+  }
+
+  [[nodiscard]] auto GetOutEdges(size_t id) const -> OutEdges {
+    CheckFinalized();
+    if (id >= vertices.size()) {
+      throw "cannot find node in the graph";
+    }
+    return OutEdges{
+      edges.data(),
+      Span<const size_t>{
+        incident.data() + offsets[id], offsets[id + 1] - offsets[id]
+      },
+      id
+    };
+  }
+
+  [[nodiscard]] auto GetOutEdges(const VertexType& v) const -> OutEdges {
+    return GetOutEdges(v.ID());
+  }
+
+  [[nodiscard]] auto Size() const -> size_t { return vertices.size(); }
+
+  friend auto operator<<(std::ostream& os, const UndirectedGraph& g)
+    -> std::ostream& {
+    for (size_t v = 0; v < g.Size(); ++v) {
+      os << "Vertex " << g.vertices[v].ID() << std::endl;
+      for (const EdgeType& e: g.GetOutEdges(v)) {
+        os << "\t"
+           << " (" << e.ID1() << " -> " << e.ID2() << ")" << std::endl;
+      }
+    }
+    return os;
+  }
+
+private:
+
+  auto Reserve(const size_t vertex_count) -> void {
+    while (vertices.size() < vertex_count) {
+      vertices.emplace_back(vertices.size());
+    }
+  }
+
+  auto CheckFinalized() const -> void {
+    if (!IsFinalized()) {
+      throw "graph is not finalized";
+    }
+  }
+
+  // vertex objects indexed by ID
+  std::vector<VertexType> vertices;
+
+  // edges at vertex v are edges[incident[offsets[v] .. offsets[v + 1])]
+  std::vector<size_t> offsets;
+  std::vector<size_t> incident;
+
+  // every edge once, in insertion order
+  std::vector<EdgeType> edges;
+
+  // edges covered by the incidence arrays
+  size_t built;
+};
+
+#endif
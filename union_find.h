@@ -0,0 +1,166 @@
+/*!
+  \brief  Disjoint sets using a flat parent array (union by rank, path
+  halving) - drop-in alternative to DisjointSets
+
+Implements:
+  ctor (size)
+  Make( id )      initialize
+  Reset()         forget every element, keep the storage
+  Join( id,id )   join 2 sets
+  GetRepresentative( id )
+
+Rationale:
+  elements of the set are assumed to be contiguous 0,1,2,3,....
+  One parent index and one byte of rank per element, both allocated once in
+  the constructor - no per-element nodes. Finds are iterative, so long
+  chains cannot overflow the stack, and halve the path they walk.
+  BasicUnionFind<uint32_t> halves the parent array for up to 2^32 elements,
+  UnionFind is the size_t version.
+*/
+
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "mst_stats.h"
+
+/**
+ * @class BasicUnionFind
+ * @brief Union-find with the DisjointSets interface, parents stored as Index
+ */
+template<typename Index>
+class BasicUnionFind {
+public:
+
+  static_assert(std::is_unsigned_v<Index>, "indices are unsigned");
+
+  // storage per element: parent and rank
+  static constexpr size_t kElementBytes = sizeof(Index) + sizeof(uint8_t);
+
+  /**
+   * @brief Constructor to create a disjoint list with a fixed inner capacity
+   */
+  explicit BasicUnionFind(size_t capacity);
+
+  BasicUnionFind(const BasicUnionFind&) = delete;
+  BasicUnionFind& operator=(const BasicUnionFind&) = delete;
+  BasicUnionFind(BasicUnionFind&&) = delete;
+  BasicUnionFind& operator=(BasicUnionFind&&) = delete;
+
+  /**
+   * @brief Creates a new representative with ID of the current size
+   */
+  auto Make() -> void;
+
+  /**
+   * @brief Forgets every element, the next Make() creates ID 0 again
+   */
+  auto Reset() -> void { size = 0; }
+
+  /**
+   * @brief Joins the two represntatives together, the higher rank root wins
+   */
+  auto Join(size_t id1, size_t id2) -> void;
+
+  /**
+   * @brief Gets representative index from the given id (halves the path)
+   */
+  [[nodiscard]] auto GetRepresentative(size_t id) const -> size_t;
+
+  /**
+   * @brief Raw index into the parent array
+   */
+  [[nodiscard]] auto operator[](size_t id) const -> size_t;
+
+  /**
+   * @brief Prints every element with its parent and representative
+   */
+  template<typename I>
+  friend auto operator<<(std::ostream& os, const BasicUnionFind<I>& uf)
+    -> std::ostream&;
+
+private:
+
+  // current size
+  size_t size{0};
+
+  // capacity - NOT growing, provided as ctor arg
+  size_t capacity{0};
+
+  // parent links, roots point to themselves
+  std::unique_ptr<Index[]> parents{nullptr};
+
+  // upper bound on the height of each root's tree
+  std::unique_ptr<uint8_t[]> ranks{nullptr};
+};
+
+/**
+ * @brief The default, size_t parents
+ */
+using UnionFind = BasicUnionFind<size_t>;
+
+template<typename Index>
+BasicUnionFind<Index>::BasicUnionFind(const size_t capacity):
+    size(0),
+    capacity(capacity),
+    parents{new Index[capacity]},
+    ranks{new uint8_t[capacity]} {}
+
+template<typename Index>
+auto BasicUnionFind<Index>::Make() -> void {
+  parents[size] = static_cast<Index>(size);
+  ranks[size] = 0;
+  ++size;
+}
+
+template<typename Index>
+auto BasicUnionFind<Index>::Join(const size_t id1, const size_t id2) -> void {
+  size_t rep1 = GetRepresentative(id1);
+  size_t rep2 = GetRepresentative(id2);
+
+  if (rep1 == rep2) {
+    return;
+  }
+
+  if (ranks[rep1] > ranks[rep2]) {
+    std::swap(rep1, rep2);
+  }
+
+  parents[rep1] = static_cast<Index>(rep2);
+  MST_STATS_ADD(nodes_relabelled, 1);
+  if (ranks[rep1] == ranks[rep2]) {
+    ++ranks[rep2];
+  }
+}
+
+template<typename Index>
+auto BasicUnionFind<Index>::GetRepresentative(size_t id) const -> size_t {
+  MST_STATS_FIND_PATH(path);
+  while (parents[id] != id) {
+    parents[id] = parents[parents[id]];
+    id = parents[id];
+    MST_STATS_FIND_STEP(path);
+  }
+  return id;
+}
+
+template<typename Index>
+auto BasicUnionFind<Index>::operator[](const size_t id) const -> size_t {
+  return parents[id];
+}
+
+template<typename Index>
+auto operator<<(std::ostream& os, const BasicUnionFind<Index>& uf)
+  -> std::ostream& {
+  for (size_t i = 0; i < uf.size; ++i) {
+    os << i << ":  parent " << uf.parents[i] << " (representative "
+       << uf.GetRepresentative(i) << ")\n";
+  }
+  return os;
+}
+
+#endif